@@ -0,0 +1,256 @@
+#include "batchcollector.h"
+#include "giosdate.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <charconv>
+
+Q_LOGGING_CATEGORY(lcCollector, "stacje.collector", QtWarningMsg)
+
+// Wartość float jako double o najkrótszym zapisie dziesiętnym tej wartości
+// (23.7f zamiast 23.700000762939453) - pomiary w API mają taką precyzję
+static double shortestDouble(float value) {
+    char buffer[32];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return QByteArray(buffer, int(result.ptr - buffer)).toDouble();
+}
+
+BatchCollector::BatchCollector(GiosClient *client, HistoryStore *historyStore, QObject *parent)
+    : QObject(parent),
+    m_client(client),
+    m_historyStore(historyStore),
+    m_output(StoreOutput),
+    m_pending(0),
+    m_failures(0) {
+
+    connect(m_client, &GiosClient::stationListReceived, this, &BatchCollector::handleStationList);
+    connect(m_client, &GiosClient::stationSensorsReceived, this, &BatchCollector::handleStationSensors);
+    connect(m_client, &GiosClient::sensorDataReceived, this, &BatchCollector::handleSensorData);
+
+    // Ten sam katalog stacji co w oknie aplikacji
+    m_catalog.setSnapshotPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                              + "/catalog.bin");
+}
+
+bool CollectorJobs::readFile(const QString &path, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = QString("Nie można otworzyć pliku zadań %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const qsizetype space = line.indexOf(' ');
+        const QString kind = line.left(space);
+        const QString value = space < 0 ? QString() : line.mid(space + 1).trimmed();
+        bool idOk = false;
+        const int id = value.toInt(&idOk);
+
+        if (kind == "city" && !value.isEmpty()) {
+            cities.append(value);
+        } else if (kind == "station" && idOk) {
+            stations.append(id);
+        } else if (kind == "sensor" && idOk) {
+            sensors.append(id);
+        } else if (kind == "all" && value.isEmpty()) {
+            allStations = true;
+        } else {
+            *error = QString("%1:%2: niepoprawne zadanie \"%3\"").arg(path).arg(lineNumber).arg(line);
+            return false;
+        }
+    }
+    return true;
+}
+
+QList<int> stationsForJobs(const CollectorJobs &jobs, const StationCatalog &catalog, QStringList *missingCities) {
+    QList<int> result;
+    if (jobs.allStations) {
+        for (const StationRecord &station : catalog.stations()) {
+            result.append(station.id);
+        }
+        return result;
+    }
+
+    for (const QString &cityName : jobs.cities) {
+        const QList<StationRecord> stations = catalog.stationsInCity(cityName);
+        if (stations.isEmpty()) {
+            missingCities->append(cityName);
+        }
+        for (const StationRecord &station : std::as_const(stations)) {
+            result.append(station.id);
+        }
+    }
+    return result;
+}
+
+void BatchCollector::start() {
+    if (!m_jobs.cities.isEmpty() || m_jobs.allStations) {
+        // Stacje miast wyszukujemy w zapisanym katalogu; brakujący lub
+        // nieaktualny katalog najpierw pobieramy
+        m_catalog.loadSnapshot();
+        if (m_catalog.isEmpty() || !m_catalog.isFresh()) {
+            m_pending++;
+            m_client->fetchStationList(RequestScheduler::Interactive);
+        } else {
+            resolveCatalogJobs();
+        }
+    }
+
+    for (int stationId : std::as_const(m_jobs.stations)) {
+        fetchStation(stationId);
+    }
+    for (int sensorId : std::as_const(m_jobs.sensors)) {
+        fetchSensor(sensorId, 0);
+    }
+
+    // Nie było czego pobierać (np. brak stacji w mieście)
+    if (m_pending == 0) {
+        emit finished(m_failures > 0 ? 1 : 0);
+    }
+}
+
+void BatchCollector::handleStationList(const ParsedReply &reply) {
+    if (reply.error == QNetworkReply::NoError) {
+        m_catalog.setSnapshot(reply.catalogSnapshot);
+    } else if (m_catalog.isEmpty()) {
+        fail("Błąd podczas pobierania katalogu stacji: " + reply.errorString);
+    } else {
+        qCDebug(lcCollector) << "Nie udało się odświeżyć katalogu stacji:" << reply.errorString;
+    }
+
+    resolveCatalogJobs();
+    completeRequest();
+}
+
+void BatchCollector::resolveCatalogJobs() {
+    if (m_catalog.isEmpty()) {
+        return;
+    }
+
+    QStringList missingCities;
+    const QList<int> stations = stationsForJobs(m_jobs, m_catalog, &missingCities);
+    for (const QString &cityName : std::as_const(missingCities)) {
+        fail("Nie znaleziono stacji w mieście: " + cityName);
+    }
+    for (int stationId : stations) {
+        fetchStation(stationId);
+    }
+}
+
+void BatchCollector::fetchStation(int stationId) {
+    if (m_requestedStations.contains(stationId)) {
+        return;
+    }
+    m_requestedStations.insert(stationId);
+    m_pending++;
+    m_client->fetchStationSensors(stationId);
+}
+
+void BatchCollector::fetchSensor(int sensorId, int stationId) {
+    if (m_requestedSensors.contains(sensorId)) {
+        return;
+    }
+    m_requestedSensors.insert(sensorId);
+    m_pending++;
+    m_client->fetchSensorData(sensorId, stationId);
+}
+
+void BatchCollector::handleStationSensors(int stationId, const ParsedReply &reply) {
+    if (reply.error != QNetworkReply::NoError) {
+        fail(QString("Błąd podczas pobierania czujników stacji %1: %2").arg(stationId).arg(reply.errorString));
+    } else {
+        for (const SensorReading &sensor : reply.sensors) {
+            m_sensorMeta.insert(sensor.sensorId, sensor);
+            fetchSensor(sensor.sensorId, stationId);
+        }
+    }
+    completeRequest();
+}
+
+void BatchCollector::handleSensorData(int sensorId, int stationId, const ParsedReply &reply) {
+    if (reply.error != QNetworkReply::NoError) {
+        fail(QString("Błąd podczas pobierania pomiarów czujnika %1: %2").arg(sensorId).arg(reply.errorString));
+        completeRequest();
+        return;
+    }
+
+    TimeSeries series = reply.values;
+    series.info().sensorId = sensorId;
+
+    // Czujnik podany bezpośrednio (bez station/sensors) - opis z zapisanej historii
+    const auto sensorIt = m_sensorMeta.constFind(sensorId);
+    if (sensorIt != m_sensorMeta.constEnd()) {
+        series.info().param = sensorIt->param;
+        series.info().paramFormula = sensorIt->paramFormula;
+    } else {
+        const SeriesInfo stored = m_historyStore->load(sensorId).info();
+        series.info().param = stored.param;
+        series.info().paramFormula = stored.paramFormula;
+    }
+
+    writeSeries(stationId, series);
+    completeRequest();
+}
+
+void BatchCollector::writeSeries(int stationId, const TimeSeries &series) {
+    if (m_output == StoreOutput) {
+        int addedCount = 0;
+        bool saved = false;
+        const TimeSeries merged = m_historyStore->merge(series, &addedCount, &saved);
+        if (!saved) {
+            fail(QString("Nie udało się zapisać historii czujnika %1").arg(series.info().sensorId));
+            return;
+        }
+        qCDebug(lcCollector) << "Czujnik" << series.info().sensorId << series.info().paramFormula
+                             << "- nowych pomiarów:" << addedCount << "w historii:" << merged.size();
+        return;
+    }
+
+    // Jeden wiersz na czujnik, pomiary rosnąco po czasie
+    QJsonArray values;
+    for (int i = 0; i < series.size(); ++i) {
+        QJsonObject value;
+        value["date"] = GiosDate::format(series.timestampAt(i));
+        value["value"] = shortestDouble(series.valueAt(i));
+        values.append(value);
+    }
+
+    QJsonObject line;
+    line["stationId"] = stationId;
+    line["sensorId"] = series.info().sensorId;
+    line["param"] = series.info().param;
+    line["paramFormula"] = series.info().paramFormula;
+    line["unit"] = series.info().unit;
+    line["values"] = values;
+
+    QTextStream out(stdout);
+    out << QJsonDocument(line).toJson(QJsonDocument::Compact) << '\n';
+}
+
+void BatchCollector::completeRequest() {
+    if (--m_pending > 0) {
+        return;
+    }
+
+    // Dziennik historii trafia do pliku .dat przed zakończeniem procesu
+    m_historyStore->waitForCompaction();
+    qCDebug(lcCollector) << "Pobieranie zakończone; stacje:" << m_requestedStations.size()
+                         << "czujniki:" << m_requestedSensors.size() << "błędy:" << m_failures;
+    emit finished(m_failures > 0 ? 1 : 0);
+}
+
+void BatchCollector::fail(const QString &message) {
+    m_failures++;
+    qWarning().noquote() << message;
+}
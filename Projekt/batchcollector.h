@@ -0,0 +1,90 @@
+#ifndef BATCHCOLLECTOR_H
+#define BATCHCOLLECTOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+#include "giosclient.h"
+#include "stationcatalog.h"
+#include "historystore.h"
+
+// Postęp pobierania bez interfejsu - domyślnie wyłączony, włączany przez
+// QT_LOGGING_RULES="stacje.collector.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcCollector)
+
+// Zadania pobierania bez interfejsu: miasta (wszystkie ich stacje), stacje
+// (wszystkie ich czujniki), pojedyncze czujniki albo wszystkie stacje z katalogu
+struct CollectorJobs {
+    QStringList cities;
+    QList<int> stations;
+    QList<int> sensors;
+    bool allStations = false;
+
+    bool isEmpty() const { return cities.isEmpty() && stations.isEmpty() && sensors.isEmpty() && !allStations; }
+    // Wiersze pliku: "city <nazwa>", "station <id>", "sensor <id>" lub "all";
+    // puste wiersze i wiersze zaczynające się od # są pomijane
+    bool readFile(const QString &path, QString *error);
+};
+
+// Stacje zadań wymagających katalogu (miasta, wszystkie stacje). Miasta są
+// dopasowywane tylko dokładnie (bez względu na wielkość liter i ogonki) - zadanie
+// bez nadzoru nie może po cichu pobrać danych innego miasta. Miasta bez stacji
+// trafiają do missingCities.
+QList<int> stationsForJobs(const CollectorJobs &jobs, const StationCatalog &catalog, QStringList *missingCities);
+
+// Jednorazowe pobranie pomiarów dla zadań (stacje_pomiarowe --headless).
+// Pomiary trafiają do lokalnej historii (HistoryStore) albo na standardowe
+// wyjście - jeden wiersz JSON na czujnik.
+class BatchCollector : public QObject {
+    Q_OBJECT
+
+public:
+    enum Output {
+        StoreOutput,   // Scalenie z historią w HistoryStore
+        StdoutOutput   // Wiersze JSON na standardowym wyjściu
+    };
+
+    BatchCollector(GiosClient *client, HistoryStore *historyStore, QObject *parent = nullptr);
+
+    void setJobs(const CollectorJobs &jobs) { m_jobs = jobs; }
+    void setOutput(Output output) { m_output = output; }
+
+    // Rozpoczyna pobieranie; po odebraniu wszystkich odpowiedzi emituje finished()
+    void start();
+
+signals:
+    // exitCode: 0 - wszystko pobrane, 1 - część zadań się nie powiodła
+    void finished(int exitCode);
+
+private:
+    void handleStationList(const ParsedReply &reply);
+    void handleStationSensors(int stationId, const ParsedReply &reply);
+    void handleSensorData(int sensorId, int stationId, const ParsedReply &reply);
+
+    // Stacje zadanych miast (lub wszystkie) według katalogu
+    void resolveCatalogJobs();
+    void fetchStation(int stationId);
+    void fetchSensor(int sensorId, int stationId);
+    void writeSeries(int stationId, const TimeSeries &series);
+    // Odnotowuje odpowiedź; po ostatniej kończy pracę
+    void completeRequest();
+    void fail(const QString &message);
+
+    GiosClient *m_client;
+    HistoryStore *m_historyStore;
+    StationCatalog m_catalog;
+    CollectorJobs m_jobs;
+    Output m_output;
+
+    QSet<int> m_requestedStations;          // Stacje i czujniki już pobierane -
+    QSet<int> m_requestedSensors;           // każdy tylko raz, nawet z kilku zadań
+    QHash<int, SensorReading> m_sensorMeta; // Opis czujników z odpowiedzi station/sensors
+    int m_pending;                          // Żądania bez odpowiedzi
+    int m_failures;
+};
+
+#endif // BATCHCOLLECTOR_H
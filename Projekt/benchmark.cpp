@@ -0,0 +1,465 @@
+#include "benchmark.h"
+#include "giosdate.h"
+#include "giosdecoders.h"
+#include "responsecache.h"
+#include "seriescodec.h"
+#include "timeseries.h"
+#include <QDateTime>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimeZone>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// Minimalny czas pomiaru jednego wariantu
+const qint64 MinMeasureNs = 200 * 1000 * 1000;
+const double Pi = 3.14159265358979323846;
+
+// Seria godzinowa podobna do danych GIOŚ: dobowy cykl, szum, wartości
+// z czterema miejscami po przecinku i sporadyczne braki pomiarów
+TimeSeries syntheticSeries(int count) {
+    TimeSeries series;
+    series.info().unit = "PM10";
+    series.reserve(count);
+
+    QRandomGenerator random(2024);
+    const qint64 hourMs = 60 * 60 * 1000;
+    qint64 timestamp = 1704067200000; // 2024-01-01 00:00 UTC
+    double level = 25.0;
+
+    for (int i = 0; i < count; ++i) {
+        timestamp += random.bounded(40) == 0 ? 2 * hourMs : hourMs;
+        level = qMax(1.0, level + (random.generateDouble() - 0.5) * 2.0);
+        const double daily = 8.0 * std::sin(i * 2.0 * Pi / 24.0);
+        const double value = std::round(qMax(0.0, level + daily) * 10000.0) / 10000.0;
+        series.append(timestamp, float(value));
+    }
+    return series;
+}
+
+// Ten sam układ pomiarów, który zapisuje MainWindow::saveSensorDataToJson()
+QByteArray toJson(const TimeSeries &series) {
+    QJsonArray measurements;
+    for (int i = series.size() - 1; i >= 0; --i) {
+        QJsonObject measurement;
+        measurement["date"] = GiosDate::format(series.timestampAt(i));
+        measurement["value"] = double(series.valueAt(i));
+        measurement["unit"] = series.info().unit;
+        measurements.append(measurement);
+    }
+
+    QJsonObject root;
+    root["measurements"] = measurements;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+TimeSeries fromJson(const QByteArray &json) {
+    const QJsonArray measurements = QJsonDocument::fromJson(json).object()["measurements"].toArray();
+    TimeSeries series;
+    series.reserve(measurements.size());
+    for (const QJsonValue &value : measurements) {
+        const QJsonObject measurement = value.toObject();
+        series.append(GiosDate::parse(measurement["date"].toString()), float(measurement["value"].toDouble()));
+    }
+    series.sortByTime();
+    return series;
+}
+
+// Powtarza dekodowanie aż do MinMeasureNs i zwraca średni czas jednego przebiegu
+template <typename Decode>
+double measureNs(Decode decode) {
+    QElapsedTimer timer;
+    timer.start();
+    int runs = 0;
+    do {
+        decode();
+        ++runs;
+    } while (timer.nsecsElapsed() < MinMeasureNs);
+    return double(timer.nsecsElapsed()) / runs;
+}
+
+bool sameSeries(const TimeSeries &a, const TimeSeries &b) {
+    return a.timestamps() == b.timestamps() && a.values() == b.values();
+}
+
+void benchmarkCodec(QTextStream &out, int count) {
+    const TimeSeries series = syntheticSeries(count);
+
+    const QByteArray json = toJson(series);
+    const QByteArray encoded = SeriesCodec::encode(series);
+
+    TimeSeries decoded;
+    SeriesCodec::decode(encoded.constData(), encoded.size(), decoded);
+    // JSON nie jest porównywany: daty w czasie lokalnym tracą godzinę przy zmianie czasu
+    const bool lossless = sameSeries(series, decoded);
+
+    const double jsonNs = measureNs([&json]() {
+        fromJson(json);
+    });
+    const double codecNs = measureNs([&encoded]() {
+        TimeSeries result;
+        SeriesCodec::decode(encoded.constData(), encoded.size(), result);
+    });
+
+    out << QString("  %1 punktów%2\n").arg(count).arg(lossless ? "" : " (BŁĄD: dane różnią się po dekodowaniu)");
+    out << QString("    JSON:        %1 B/punkt, dekodowanie %2 mln punktów/s\n")
+               .arg(double(json.size()) / count, 0, 'f', 2)
+               .arg(count / jsonNs * 1000.0, 0, 'f', 2);
+    out << QString("    SeriesCodec: %1 B/punkt, dekodowanie %2 mln punktów/s (%3x mniej danych, %4x szybciej)\n")
+               .arg(double(encoded.size()) / count, 0, 'f', 2)
+               .arg(count / codecNs * 1000.0, 0, 'f', 2)
+               .arg(double(json.size()) / encoded.size(), 0, 'f', 1)
+               .arg(jsonNs / codecNs, 0, 'f', 1);
+}
+
+// Odpowiedzi API porównywane w benchmarkDecoders()
+enum PayloadKind {
+    SensorsPayload,
+    ValuesPayload,
+    IndexPayload,
+    PayloadKindCount
+};
+
+// Odpowiedzi zapisane w pamięci podręcznej aplikacji (ResponseCache), według rodzaju
+void loadRecordedPayloads(QList<QByteArray> payloads[PayloadKindCount]) {
+    ResponseCache cache;
+    QDirIterator it(cache.cacheDirectory(), {"*.d"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QUrl url = cache.fileMetaData(it.next()).url();
+        const QString path = url.path();
+
+        PayloadKind kind;
+        if (path.contains("/station/sensors/")) {
+            kind = SensorsPayload;
+        } else if (path.contains("/data/getData/")) {
+            kind = ValuesPayload;
+        } else if (path.contains("/aqindex/getIndex/")) {
+            kind = IndexPayload;
+        } else {
+            continue;
+        }
+
+        std::unique_ptr<QIODevice> device(cache.data(url));
+        if (device) {
+            payloads[kind].append(device->readAll());
+        }
+    }
+}
+
+// Odpowiedzi w układzie API GIOŚ, gdy pamięć podręczna jest pusta
+void addSyntheticPayloads(QList<QByteArray> payloads[PayloadKindCount]) {
+    struct Param {
+        const char *name;
+        const char *formula;
+        int id;
+    };
+    static const Param Params[] = {
+        {"pył zawieszony PM10", "PM10", 3},
+        {"pył zawieszony PM2.5", "PM2.5", 69},
+        {"dwutlenek azotu", "NO2", 6},
+        {"ozon", "O3", 5},
+        {"benzen", "C6H6", 10},
+        {"tlenek węgla", "CO", 8}
+    };
+
+    if (payloads[SensorsPayload].isEmpty()) {
+        QJsonArray sensors;
+        for (int i = 0; i < 6; ++i) {
+            QJsonObject param;
+            param["paramName"] = QString::fromUtf8(Params[i].name);
+            param["paramFormula"] = Params[i].formula;
+            param["paramCode"] = Params[i].formula;
+            param["idParam"] = Params[i].id;
+
+            QJsonObject sensor;
+            sensor["id"] = 92 + i;
+            sensor["stationId"] = 14;
+            sensor["param"] = param;
+            sensors.append(sensor);
+        }
+        payloads[SensorsPayload].append(QJsonDocument(sensors).toJson(QJsonDocument::Compact));
+    }
+
+    if (payloads[ValuesPayload].isEmpty()) {
+        // API podaje ostatnie 3 dni, od najnowszych; ostatnie godziny bywają puste
+        for (const Param &param : Params) {
+            const TimeSeries series = syntheticSeries(72 + param.id);
+            QJsonArray values;
+            for (int i = series.size() - 1; i >= 0; --i) {
+                QJsonObject value;
+                value["date"] = GiosDate::format(series.timestampAt(i));
+                value["value"] = i >= series.size() - 2 ? QJsonValue() : QJsonValue(double(series.valueAt(i)));
+                values.append(value);
+            }
+
+            QJsonObject root;
+            root["key"] = param.formula;
+            root["values"] = values;
+            payloads[ValuesPayload].append(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        }
+    }
+
+    if (payloads[IndexPayload].isEmpty()) {
+        QJsonObject level;
+        level["id"] = 1;
+        level["indexLevelName"] = "Dobry";
+
+        QJsonObject root;
+        root["id"] = 14;
+        root["stCalcDate"] = "2024-01-03 12:20:00";
+        root["stIndexLevel"] = level;
+        root["stSourceDataDate"] = "2024-01-03 12:00:00";
+        for (const char *param : {"so2", "no2", "pm10", "pm25", "o3"}) {
+            const QString prefix = QString::fromLatin1(param);
+            root[prefix + "CalcDate"] = "2024-01-03 12:20:00";
+            root[prefix + "IndexLevel"] = level;
+            root[prefix + "SourceDataDate"] = "2024-01-03 12:00:00";
+        }
+        payloads[IndexPayload].append(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    }
+}
+
+// Dotychczasowe parsowanie przez drzewo QJsonDocument - punkt odniesienia
+QList<SensorReading> sensorsFromJson(const QByteArray &body) {
+    const QJsonArray array = QJsonDocument::fromJson(body).array();
+    QList<SensorReading> sensors;
+    sensors.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonObject sensor = value.toObject();
+        const QJsonObject param = sensor["param"].toObject();
+
+        SensorReading reading;
+        reading.sensorId = sensor["id"].toInt();
+        reading.position = sensors.size();
+        reading.param = param["paramName"].toString();
+        reading.paramCode = param["paramCode"].toString();
+        reading.paramFormula = param["paramFormula"].toString();
+        sensors.append(reading);
+    }
+    return sensors;
+}
+
+TimeSeries valuesFromJson(const QByteArray &body) {
+    const QJsonObject root = QJsonDocument::fromJson(body).object();
+    const QJsonArray values = root["values"].toArray();
+
+    TimeSeries series;
+    series.info().unit = root["key"].toString();
+    series.reserve(values.size());
+    for (const QJsonValue &value : values) {
+        const QJsonObject reading = value.toObject();
+        if (reading["value"].isNull()) {
+            continue;
+        }
+        bool dateOk = false;
+        const double readingValue = reading["value"].toDouble(-1);
+        const qint64 timestamp = GiosDate::parse(reading["date"].toString(), &dateOk);
+        if (readingValue >= 0 && dateOk) {
+            series.append(timestamp, float(readingValue));
+        }
+    }
+    series.sortByTime();
+    return series;
+}
+
+QString indexFromJson(const QByteArray &body) {
+    const QJsonObject root = QJsonDocument::fromJson(body).object();
+    const QJsonValue station = root["stIndexLevel"];
+    if (station.isObject()) {
+        return station.toObject()["indexLevelName"].toString();
+    }
+    const QJsonValue pm10 = root["pm10IndexLevel"];
+    if (pm10.isObject()) {
+        return pm10.toObject()["indexLevelName"].toString();
+    }
+    return QString();
+}
+
+bool sameSensors(const QList<SensorReading> &a, const QList<SensorReading> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].sensorId != b[i].sensorId || a[i].position != b[i].position || a[i].param != b[i].param
+            || a[i].paramCode != b[i].paramCode || a[i].paramFormula != b[i].paramFormula) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Dekoduje wszystkie odpowiedzi danego rodzaju; zwraca false przy różnicy wyników
+bool decodeAll(PayloadKind kind, const QList<QByteArray> &payloads, bool viaJson) {
+    bool same = true;
+    for (const QByteArray &body : payloads) {
+        switch (kind) {
+        case SensorsPayload: {
+            QList<SensorReading> sensors;
+            GiosDecoders::decodeStationSensors(body, &sensors);
+            if (viaJson) {
+                same = sameSensors(sensorsFromJson(body), sensors) && same;
+            }
+            break;
+        }
+        case ValuesPayload: {
+            TimeSeries series;
+            GiosDecoders::decodeSensorValues(body, &series);
+            if (viaJson) {
+                const TimeSeries reference = valuesFromJson(body);
+                same = sameSeries(reference, series) && reference.info().unit == series.info().unit && same;
+            }
+            break;
+        }
+        case IndexPayload: {
+            bool hasData = false;
+            QString level;
+            GiosDecoders::decodeAirQualityIndex(body, &hasData, &level);
+            if (viaJson) {
+                same = indexFromJson(body) == level && same;
+            }
+            break;
+        }
+        case PayloadKindCount:
+            break;
+        }
+    }
+    return same;
+}
+
+void benchmarkDecoders(QTextStream &out) {
+    static const char *const Names[PayloadKindCount] = {
+        "station/sensors", "data/getData", "aqindex/getIndex"
+    };
+
+    QList<QByteArray> payloads[PayloadKindCount];
+    loadRecordedPayloads(payloads);
+    int recorded[PayloadKindCount];
+    for (int kind = 0; kind < PayloadKindCount; ++kind) {
+        recorded[kind] = payloads[kind].size();
+    }
+    addSyntheticPayloads(payloads);
+
+    for (int kind = 0; kind < PayloadKindCount; ++kind) {
+        const QList<QByteArray> &bodies = payloads[kind];
+        qint64 bytes = 0;
+        for (const QByteArray &body : bodies) {
+            bytes += body.size();
+        }
+
+        // Porównanie wyników przy okazji pierwszego przebiegu
+        const bool same = decodeAll(PayloadKind(kind), bodies, true);
+
+        const double jsonNs = measureNs([&bodies, kind]() {
+            for (const QByteArray &body : bodies) {
+                switch (kind) {
+                case SensorsPayload:
+                    sensorsFromJson(body);
+                    break;
+                case ValuesPayload:
+                    valuesFromJson(body);
+                    break;
+                default:
+                    indexFromJson(body);
+                    break;
+                }
+            }
+        });
+        const double decoderNs = measureNs([&bodies, kind]() {
+            decodeAll(PayloadKind(kind), bodies, false);
+        });
+
+        out << QString("  %1: %2 odpowiedzi (%3), %4 B%5\n")
+                   .arg(Names[kind])
+                   .arg(bodies.size())
+                   .arg(recorded[kind] > 0 ? "zapisane w pamięci podręcznej" : "wygenerowane")
+                   .arg(bytes)
+                   .arg(same ? "" : " (BŁĄD: wyniki różnią się od QJsonDocument)");
+        out << QString("    QJsonDocument: %1 µs/odpowiedź, %2 MB/s\n")
+                   .arg(jsonNs / bodies.size() / 1000.0, 0, 'f', 2)
+                   .arg(bytes / jsonNs * 1000.0, 0, 'f', 1);
+        out << QString("    GiosDecoders:  %1 µs/odpowiedź, %2 MB/s (%3x szybciej)\n")
+                   .arg(decoderNs / bodies.size() / 1000.0, 0, 'f', 2)
+                   .arg(bytes / decoderNs * 1000.0, 0, 'f', 1)
+                   .arg(jsonNs / decoderNs, 0, 'f', 1);
+    }
+}
+
+// Kolejne godziny czasu polskiego z dwóch lat - także nieistniejące i podwójne
+// godziny przy zmianie czasu. Wynik GiosDate::parse jest porównywany z QDateTime.
+void benchmarkDates(QTextStream &out) {
+    const QTimeZone zone("Europe/Warsaw");
+    const QString format = "yyyy-MM-dd HH:mm:ss";
+
+    QList<QString> texts;
+    QList<QByteArray> bytes;
+    QList<qint64> expected;
+    for (QDate date(2024, 1, 1); date.year() < 2026; date = date.addDays(1)) {
+        for (int hour = 0; hour < 24; ++hour) {
+            const QTime time(hour, 17, 42);
+            const QString text = date.toString("yyyy-MM-dd") + time.toString(" HH:mm:ss");
+            texts.append(text);
+            bytes.append(text.toLatin1());
+            expected.append(QDateTime(date, time, zone).toMSecsSinceEpoch());
+        }
+    }
+
+    int matching = 0;
+    for (int i = 0; i < bytes.size(); ++i) {
+        bool ok = false;
+        if (GiosDate::parse(bytes[i], &ok) == expected[i] && ok) {
+            ++matching;
+        }
+    }
+
+    const double qtNs = measureNs([&texts, &format, &zone]() {
+        for (const QString &text : texts) {
+            QDateTime dateTime = QDateTime::fromString(text, format);
+            dateTime.setTimeZone(zone);
+            dateTime.toMSecsSinceEpoch();
+        }
+    });
+    const double parseNs = measureNs([&bytes]() {
+        for (const QByteArray &text : bytes) {
+            GiosDate::parse(text);
+        }
+    });
+
+    out << QString("  %1 dat, zgodnych z QDateTime: %2%3\n")
+               .arg(bytes.size())
+               .arg(matching)
+               .arg(matching == bytes.size() ? "" : " (BŁĄD)");
+    out << QString("    QDateTime::fromString: %1 ns/datę\n").arg(qtNs / bytes.size(), 0, 'f', 1);
+    out << QString("    GiosDate::parse:       %1 ns/datę (%2x szybciej)\n")
+               .arg(parseNs / bytes.size(), 0, 'f', 1)
+               .arg(qtNs / parseNs, 0, 'f', 1);
+}
+
+} // namespace
+
+namespace Benchmark {
+
+int run() {
+    QTextStream out(stdout);
+
+    out << "Kompresja historii (SeriesCodec) w porównaniu z plikiem JSON:\n";
+    for (int count : {24 * 30, 24 * 365, 100000}) {
+        benchmarkCodec(out, count);
+    }
+
+    out << "\nDekodowanie odpowiedzi API (GiosDecoders) w porównaniu z QJsonDocument:\n";
+    benchmarkDecoders(out);
+
+    out << "\nParsowanie dat GIOŚ (czas polski) w porównaniu z QDateTime::fromString:\n";
+    benchmarkDates(out);
+    out.flush();
+    return 0;
+}
+
+} // namespace Benchmark
@@ -0,0 +1,12 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Pomiary wydajności uruchamiane z linii poleceń (stacje_pomiarowe --bench).
+// Wyniki są wypisywane na standardowe wyjście.
+namespace Benchmark {
+
+int run();
+
+} // namespace Benchmark
+
+#endif // BENCHMARK_H
@@ -0,0 +1,279 @@
+#include "catalogsnapshot.h"
+#include "stationcatalog.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+static const char SnapshotMagic[4] = {'G', 'C', 'A', 'T'};
+static const quint32 SnapshotVersion = 1;
+
+// Nagłówek: znacznik, wersja, czas utworzenia (int64), liczba stacji, liczba miast,
+// przesunięcia tabel stacji, miast i puli tekstów oraz długość puli (w znakach)
+static const int HeaderSize = 40;
+// Stacja: id i pięć odwołań do tekstów (nazwa, miasto, szer., dł., adres)
+static const int TextRefSize = 8;
+static const int StationTexts = 5;
+static const int StationEntrySize = 4 + StationTexts * TextRefSize;
+// Miasto: klucz, pierwsza stacja i liczba stacji
+static const int CityEntrySize = TextRefSize + 8;
+
+namespace {
+
+// Odwołanie do tekstu: przesunięcie i długość w puli (w znakach UTF-16)
+void putTextRef(uchar *ref, QString &pool, const QString &text) {
+    qToLittleEndian<quint32>(quint32(pool.size()), ref);
+    qToLittleEndian<quint32>(quint32(text.size()), ref + 4);
+    pool.append(text);
+}
+
+inline quint32 readU32(const uchar *data) {
+    return qFromLittleEndian<quint32>(data);
+}
+
+} // namespace
+
+CatalogSnapshot::CatalogSnapshot()
+    : m_data(nullptr),
+    m_stations(nullptr),
+    m_cities(nullptr),
+    m_strings(nullptr),
+    m_stringsLength(0),
+    m_stationCount(0),
+    m_cityCount(0),
+    m_createdAt(0) {
+}
+
+CatalogSnapshot::~CatalogSnapshot() {
+    close();
+}
+
+QByteArray CatalogSnapshot::build(const QList<StationRecord> &stations, qint64 createdAt) {
+    // Stacje układamy według klucza miasta - stacje jednego miasta leżą obok siebie
+    QList<QString> keys;
+    keys.reserve(stations.size());
+    for (const StationRecord &station : stations) {
+        keys.append(StationCatalog::normalizeCity(station.city));
+    }
+
+    QList<int> order(stations.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) {
+        return keys[a] < keys[b];
+    });
+
+    int cityCount = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        if (i == 0 || keys[order[i]] != keys[order[i - 1]]) {
+            ++cityCount;
+        }
+    }
+
+    const int stationsOffset = HeaderSize;
+    const int citiesOffset = stationsOffset + int(stations.size()) * StationEntrySize;
+    const int stringsOffset = citiesOffset + cityCount * CityEntrySize;
+
+    QByteArray tables(stringsOffset, '\0');
+    uchar *data = reinterpret_cast<uchar *>(tables.data());
+    QString pool;
+
+    uchar *cityEntry = data + citiesOffset;
+    for (int i = 0; i < order.size(); ++i) {
+        const StationRecord &station = stations[order[i]];
+        uchar *entry = data + stationsOffset + i * StationEntrySize;
+        qToLittleEndian<qint32>(station.id, entry);
+        putTextRef(entry + 4, pool, station.name);
+        putTextRef(entry + 4 + TextRefSize, pool, station.city);
+        putTextRef(entry + 4 + 2 * TextRefSize, pool, station.lat);
+        putTextRef(entry + 4 + 3 * TextRefSize, pool, station.lon);
+        putTextRef(entry + 4 + 4 * TextRefSize, pool, station.address);
+
+        // Pierwsza stacja nowego miasta otwiera wpis w tabeli miast
+        const QString &key = keys[order[i]];
+        if (i == 0 || key != keys[order[i - 1]]) {
+            if (i > 0) {
+                cityEntry += CityEntrySize;
+            }
+            putTextRef(cityEntry, pool, key);
+            qToLittleEndian<quint32>(quint32(i), cityEntry + TextRefSize);
+        }
+        const quint32 count = readU32(cityEntry + TextRefSize + 4);
+        qToLittleEndian<quint32>(count + 1, cityEntry + TextRefSize + 4);
+    }
+
+    std::memcpy(data, SnapshotMagic, sizeof(SnapshotMagic));
+    qToLittleEndian<quint32>(SnapshotVersion, data + 4);
+    qToLittleEndian<qint64>(createdAt, data + 8);
+    qToLittleEndian<quint32>(quint32(stations.size()), data + 16);
+    qToLittleEndian<quint32>(quint32(cityCount), data + 20);
+    qToLittleEndian<quint32>(quint32(stationsOffset), data + 24);
+    qToLittleEndian<quint32>(quint32(citiesOffset), data + 28);
+    qToLittleEndian<quint32>(quint32(stringsOffset), data + 32);
+    qToLittleEndian<quint32>(quint32(pool.size()), data + 36);
+
+    // Pula tekstów w UTF-16 little-endian
+    QByteArray strings(pool.size() * 2, '\0');
+    qToLittleEndian<quint16>(pool.utf16(), pool.size(), strings.data());
+    return tables + strings;
+}
+
+bool CatalogSnapshot::map(const QString &path) {
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    const uchar *data = size > 0 ? m_file.map(0, size) : nullptr;
+    if (!data || !attach(data, size)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CatalogSnapshot::setData(const QByteArray &bytes) {
+    close();
+
+    m_buffer = bytes;
+    if (!attach(reinterpret_cast<const uchar *>(m_buffer.constData()), m_buffer.size())) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CatalogSnapshot::close() {
+    m_data = nullptr;
+    m_stations = nullptr;
+    m_cities = nullptr;
+    m_strings = nullptr;
+    m_stringsLength = 0;
+    m_stationCount = 0;
+    m_cityCount = 0;
+    m_createdAt = 0;
+
+    m_buffer.clear();
+    if (m_file.isOpen()) {
+        m_file.close(); // Zamknięcie pliku usuwa też mapowanie
+    }
+}
+
+bool CatalogSnapshot::attach(const uchar *data, qint64 size) {
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+    // Teksty są czytane wprost z pliku jako UTF-16 LE
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+    return false;
+#else
+    if (size < HeaderSize || std::memcmp(data, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+        || readU32(data + 4) != SnapshotVersion) {
+        return false;
+    }
+
+    const quint32 stationCount = readU32(data + 16);
+    const quint32 cityCount = readU32(data + 20);
+    const quint32 stationsOffset = readU32(data + 24);
+    const quint32 citiesOffset = readU32(data + 28);
+    const quint32 stringsOffset = readU32(data + 32);
+    const quint32 stringsLength = readU32(data + 36);
+
+    // Tabele muszą mieścić się w pliku, a teksty być wyrównane do 2 bajtów
+    if (stationsOffset < HeaderSize
+        || qint64(stationsOffset) + qint64(stationCount) * StationEntrySize > citiesOffset
+        || qint64(citiesOffset) + qint64(cityCount) * CityEntrySize > stringsOffset
+        || qint64(stringsOffset) + qint64(stringsLength) * 2 > size
+        || stringsOffset % 2 != 0) {
+        return false;
+    }
+
+    m_data = data;
+    m_stations = data + stationsOffset;
+    m_cities = data + citiesOffset;
+    m_strings = reinterpret_cast<const char16_t *>(data + stringsOffset);
+    m_stringsLength = stringsLength;
+    m_stationCount = int(stationCount);
+    m_cityCount = int(cityCount);
+    m_createdAt = qFromLittleEndian<qint64>(data + 8);
+
+    // Jednorazowa kontrola odwołań - później czytamy bez sprawdzania
+    auto validRef = [this](const uchar *ref) {
+        return quint64(readU32(ref)) + readU32(ref + 4) <= m_stringsLength;
+    };
+    for (int i = 0; i < m_stationCount; ++i) {
+        const uchar *entry = m_stations + i * StationEntrySize;
+        for (int t = 0; t < StationTexts; ++t) {
+            if (!validRef(entry + 4 + t * TextRefSize)) {
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < m_cityCount; ++i) {
+        const uchar *entry = m_cities + i * CityEntrySize;
+        const quint64 first = readU32(entry + TextRefSize);
+        const quint64 count = readU32(entry + TextRefSize + 4);
+        if (!validRef(entry) || first + count > quint64(m_stationCount)) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+QStringView CatalogSnapshot::text(const uchar *ref) const {
+    return QStringView(m_strings + readU32(ref), qsizetype(readU32(ref + 4)));
+}
+
+StationRecord CatalogSnapshot::stationAt(int index) const {
+    StationRecord record;
+    if (index < 0 || index >= m_stationCount) {
+        return record;
+    }
+
+    const uchar *entry = m_stations + index * StationEntrySize;
+    record.id = qFromLittleEndian<qint32>(entry);
+    record.name = text(entry + 4).toString();
+    record.city = text(entry + 4 + TextRefSize).toString();
+    record.lat = text(entry + 4 + 2 * TextRefSize).toString();
+    record.lon = text(entry + 4 + 3 * TextRefSize).toString();
+    record.address = text(entry + 4 + 4 * TextRefSize).toString();
+    return record;
+}
+
+int CatalogSnapshot::findCity(QStringView cityKey) const {
+    int low = 0;
+    int high = m_cityCount;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        if (text(m_cities + middle * CityEntrySize).compare(cityKey) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low < m_cityCount && text(m_cities + low * CityEntrySize).compare(cityKey) == 0) {
+        return low;
+    }
+    return -1;
+}
+
+QList<StationRecord> CatalogSnapshot::stationsInCity(QStringView cityKey) const {
+    QList<StationRecord> result;
+
+    const int city = findCity(cityKey);
+    if (city < 0) {
+        return result;
+    }
+
+    const uchar *entry = m_cities + city * CityEntrySize;
+    const int first = int(readU32(entry + TextRefSize));
+    const int count = int(readU32(entry + TextRefSize + 4));
+    result.reserve(count);
+    for (int i = first; i < first + count; ++i) {
+        result.append(stationAt(i));
+    }
+    return result;
+}
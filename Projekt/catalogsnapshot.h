@@ -0,0 +1,62 @@
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+struct StationRecord;
+
+// Binarna migawka katalogu stacji czytana bez parsowania - zwykle wprost
+// z pliku zmapowanego do pamięci. Układ (liczby little-endian, tekst UTF-16):
+//  - nagłówek: znacznik "GCAT", wersja, czas utworzenia, liczności i przesunięcia,
+//  - tabela stacji posortowana po kluczu miasta (id i odwołania do tekstów),
+//  - tabela miast posortowana po kluczu (klucz i zakres stacji),
+//  - wspólna pula tekstów.
+class CatalogSnapshot {
+public:
+    CatalogSnapshot();
+    ~CatalogSnapshot();
+
+    // Buduje zawartość pliku migawki
+    static QByteArray build(const QList<StationRecord> &stations, qint64 createdAt);
+
+    // Mapuje plik migawki; false, jeśli go nie ma lub jest uszkodzony
+    bool map(const QString &path);
+    // Używa migawki trzymanej w pamięci (np. gdy nie udało się jej zapisać)
+    bool setData(const QByteArray &bytes);
+    void close();
+
+    bool isValid() const { return m_data != nullptr; }
+    qint64 createdAt() const { return m_createdAt; }
+
+    int stationCount() const { return m_stationCount; }
+    StationRecord stationAt(int index) const;
+
+    // Stacje miasta o znormalizowanym kluczu - wyszukiwanie binarne w tabeli miast
+    QList<StationRecord> stationsInCity(QStringView cityKey) const;
+
+private:
+    Q_DISABLE_COPY(CatalogSnapshot)
+
+    // Sprawdza nagłówek i wszystkie odwołania do tekstów
+    bool attach(const uchar *data, qint64 size);
+    QStringView text(const uchar *ref) const;
+    int findCity(QStringView cityKey) const;
+
+    QFile m_file;
+    QByteArray m_buffer;
+
+    const uchar *m_data;
+    const uchar *m_stations;
+    const uchar *m_cities;
+    const char16_t *m_strings;
+    quint32 m_stringsLength;
+    int m_stationCount;
+    int m_cityCount;
+    qint64 m_createdAt;
+};
+
+#endif // CATALOGSNAPSHOT_H
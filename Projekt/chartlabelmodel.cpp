@@ -0,0 +1,191 @@
+#include "chartlabelmodel.h"
+#include "giosdate.h"
+#include <algorithm>
+
+// Rozmiar etykiety: trzy linie tekstu (9, 8 i 8 px) z odstępami
+static const double LabelWidth = 40.0;
+static const double LabelHeight = 36.0;
+// Odstęp etykiety od punktu
+static const double LabelOffset = 10.0;
+// Ograniczamy liczbę etykiet dla czytelności
+static const int MaxLabels = 20;
+
+ChartLabelModel::ChartLabelModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+int ChartLabelModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_labels.size();
+}
+
+QVariant ChartLabelModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_labels.size()) {
+        return QVariant();
+    }
+
+    const ChartLabel &label = m_labels[index.row()];
+    switch (role) {
+    case LabelXRole:
+        return label.position.x();
+    case LabelYRole:
+        return label.position.y();
+    case ValueRole:
+        return double(label.value);
+    case Qt::DisplayRole:
+    case ValueTextRole:
+        return QString::number(label.value, 'f', 1);
+    case DateTextRole: {
+        // Format DD-MM z "yyyy-MM-dd HH:mm:ss"
+        const QString date = GiosDate::format(label.timestamp);
+        return date.mid(8, 2) + QLatin1Char('-') + date.mid(5, 2);
+    }
+    case TimeTextRole:
+        // Format HH:MM
+        return GiosDate::format(label.timestamp).mid(11, 5);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ChartLabelModel::roleNames() const {
+    return {
+        {LabelXRole, "labelX"},
+        {LabelYRole, "labelY"},
+        {ValueRole, "value"},
+        {ValueTextRole, "valueText"},
+        {DateTextRole, "dateText"},
+        {TimeTextRole, "timeText"}
+    };
+}
+
+double ChartLabelModel::labelWidth() const {
+    return LabelWidth;
+}
+
+double ChartLabelModel::labelHeight() const {
+    return LabelHeight;
+}
+
+void ChartLabelModel::place(const TimeSeries &series, const QList<int> &indices, const QList<QPointF> &points,
+                            const QSizeF &area) {
+    m_placed.clear();
+    m_placedRects.clear();
+
+    const int count = qMin(indices.size(), points.size());
+    if (count == 0 || area.isEmpty()) {
+        setLabels(m_placed);
+        return;
+    }
+
+    // Próbujemy etykietę pod punktem, a jeśli koliduje lub wychodzi poza wykres - nad nim
+    auto tryPlace = [&](int sample) {
+        if (m_placed.size() >= MaxLabels) {
+            return;
+        }
+
+        const QPointF &point = points[sample];
+        const double x = qBound(0.0, point.x() - LabelWidth / 2, qMax(0.0, area.width() - LabelWidth));
+        const double candidates[] = {point.y() + LabelOffset, point.y() - LabelOffset - LabelHeight};
+
+        for (double y : candidates) {
+            if (y < 0.0 || y + LabelHeight > area.height()) {
+                continue;
+            }
+
+            const QRectF rect(x, y, LabelWidth, LabelHeight);
+            bool overlaps = false;
+            for (const QRectF &placed : std::as_const(m_placedRects)) {
+                if (placed.intersects(rect)) {
+                    overlaps = true;
+                    break;
+                }
+            }
+            if (overlaps) {
+                continue;
+            }
+
+            const int index = indices[sample];
+            m_placed.append({series.timestampAt(index), series.valueAt(index), rect.topLeft()});
+            m_placedRects.append(rect);
+            return;
+        }
+    };
+
+    // Skrajne wartości mają pierwszeństwo
+    int minSample = 0;
+    int maxSample = 0;
+    for (int i = 1; i < count; ++i) {
+        if (points[i].y() > points[minSample].y()) {
+            minSample = i;
+        }
+        if (points[i].y() < points[maxSample].y()) {
+            maxSample = i;
+        }
+    }
+    tryPlace(maxSample);
+    if (minSample != maxSample) {
+        tryPlace(minSample);
+    }
+
+    // Pozostałe punkty od lewej; wystarczy sprawdzać co tyle próbek, ile mieści się na szerokości etykiety
+    const int step = qMax(1, int(count * LabelWidth / area.width()));
+    for (int i = 0; i < count && m_placed.size() < MaxLabels; i += step) {
+        if (i != minSample && i != maxSample) {
+            tryPlace(i);
+        }
+    }
+
+    // Kolejność od lewej, żeby przy przesuwaniu zakresu wiersze zmieniały się jak najmniej
+    std::sort(m_placed.begin(), m_placed.end(), [](const ChartLabel &a, const ChartLabel &b) {
+        return a.timestamp < b.timestamp;
+    });
+    setLabels(m_placed);
+}
+
+void ChartLabelModel::clear() {
+    setLabels(QList<ChartLabel>());
+}
+
+void ChartLabelModel::setLabels(const QList<ChartLabel> &labels) {
+    const int oldCount = m_labels.size();
+    const int newCount = labels.size();
+    const int common = qMin(oldCount, newCount);
+
+    // Wspólne wiersze aktualizujemy w miejscu - delegaty nie są tworzone od nowa
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int row = 0; row < common; ++row) {
+        const ChartLabel &current = m_labels[row];
+        const ChartLabel &label = labels[row];
+        if (current.timestamp != label.timestamp || current.value != label.value
+            || current.position != label.position) {
+            m_labels[row] = label;
+            if (firstChanged < 0) {
+                firstChanged = row;
+            }
+            lastChanged = row;
+        }
+    }
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged), index(lastChanged));
+    }
+
+    if (newCount < oldCount) {
+        beginRemoveRows(QModelIndex(), newCount, oldCount - 1);
+        m_labels.resize(newCount);
+        endRemoveRows();
+    } else if (newCount > oldCount) {
+        beginInsertRows(QModelIndex(), oldCount, newCount - 1);
+        for (int row = oldCount; row < newCount; ++row) {
+            m_labels.append(labels[row]);
+        }
+        endInsertRows();
+    }
+
+    if (newCount != oldCount) {
+        emit countChanged();
+    }
+}
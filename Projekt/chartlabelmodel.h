@@ -0,0 +1,66 @@
+#ifndef CHARTLABELMODEL_H
+#define CHARTLABELMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointF>
+#include <QRectF>
+
+#include "timeseries.h"
+
+// Etykieta punktu wykresu: pomiar i lewy górny róg etykiety we współrzędnych wykresu
+struct ChartLabel {
+    qint64 timestamp = 0;
+    float value = 0.0f;
+    QPointF position;
+};
+
+// Etykiety punktów wykresu (wartość, dzień, godzina) wyświetlane przez Repeater.
+// Położenia są wybierane w C++ tak, żeby etykiety na siebie nie nachodziły.
+// Przy zmianie zakresu istniejące wiersze są aktualizowane przez dataChanged,
+// więc Repeater używa ponownie tych samych elementów QML.
+class ChartLabelModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    // Rozmiar pojedynczej etykiety, z którego korzysta rozmieszczanie
+    Q_PROPERTY(double labelWidth READ labelWidth CONSTANT)
+    Q_PROPERTY(double labelHeight READ labelHeight CONSTANT)
+
+public:
+    enum Roles {
+        LabelXRole = Qt::UserRole + 1,
+        LabelYRole,
+        ValueRole,
+        ValueTextRole,
+        DateTextRole,
+        TimeTextRole
+    };
+
+    explicit ChartLabelModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    double labelWidth() const;
+    double labelHeight() const;
+
+    // Wybiera etykiety spośród narysowanych punktów (indices - indeksy w serii,
+    // points - ich położenie na wykresie). Najpierw minimum i maksimum, potem
+    // kolejne punkty od lewej, o ile mieszczą się pod lub nad punktem.
+    void place(const TimeSeries &series, const QList<int> &indices, const QList<QPointF> &points,
+               const QSizeF &area);
+    void clear();
+
+signals:
+    void countChanged();
+
+private:
+    void setLabels(const QList<ChartLabel> &labels);
+
+    QList<ChartLabel> m_labels;
+    // Bufory rozmieszczania używane ponownie przy każdej zmianie
+    QList<ChartLabel> m_placed;
+    QList<QRectF> m_placedRects;
+};
+
+#endif // CHARTLABELMODEL_H
@@ -0,0 +1,183 @@
+#include "citysearchindex.h"
+#include <QHash>
+#include <QVarLengthArray>
+#include <algorithm>
+
+void CitySearchIndex::build(const QList<StationRecord> &stations) {
+    // Zliczamy stacje w każdym mieście (po kluczu znormalizowanym)
+    QHash<QString, int> entryByKey;
+    m_entries.clear();
+
+    for (const StationRecord &station : stations) {
+        const QString key = StationCatalog::normalizeCity(station.city);
+        if (key.isEmpty()) {
+            continue;
+        }
+
+        auto it = entryByKey.constFind(key);
+        if (it == entryByKey.constEnd()) {
+            entryByKey.insert(key, m_entries.size());
+            m_entries.append({key, station.city.trimmed(), 1});
+        } else {
+            m_entries[it.value()].stationCount++;
+        }
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.key < b.key;
+    });
+}
+
+QList<CityMatch> CitySearchIndex::search(const QString &query, int limit) const {
+    QList<CityMatch> matches;
+    const QString key = StationCatalog::normalizeCity(query);
+    if (key.isEmpty() || m_entries.isEmpty()) {
+        return matches;
+    }
+
+    QVarLengthArray<bool, 512> taken(m_entries.size());
+    std::fill(taken.begin(), taken.end(), false);
+
+    // Dopasowania prefiksowe - wyszukiwanie binarne w posortowanych kluczach
+    auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+                               [](const Entry &entry, const QString &k) { return entry.key < k; });
+    for (; it != m_entries.cend() && it->key.startsWith(key); ++it) {
+        // Dokładne trafienie ma wynik 0, dłuższe nazwy są nieco dalej
+        const int score = it->key.size() == key.size() ? 0 : 10 + int(it->key.size() - key.size());
+        matches.append({it->city, it->stationCount, score});
+        taken[int(it - m_entries.cbegin())] = true;
+    }
+
+    // Dopasowania z literówkami - dla krótkich zapytań byłoby ich zbyt wiele
+    if (key.size() >= 3) {
+        const int maxTypos = key.size() <= 5 ? 1 : 2;
+
+        for (int i = 0; i < m_entries.size(); ++i) {
+            if (taken[i]) {
+                continue;
+            }
+
+            const Entry &entry = m_entries[i];
+            const QStringView entryKey(entry.key);
+
+            // Porównujemy z całą nazwą oraz z jej początkiem tej samej długości,
+            // bo użytkownik może być w trakcie pisania
+            int distance = boundedDistance(key, entryKey.left(key.size()), maxTypos);
+            if (distance > maxTypos) {
+                distance = boundedDistance(key, entryKey, maxTypos);
+            }
+
+            if (distance <= maxTypos) {
+                const int score = 100 + distance * 20 + int(qAbs(entry.key.size() - key.size()));
+                matches.append({entry.city, entry.stationCount, score});
+            }
+        }
+    }
+
+    // Ranking: wynik dopasowania, potem miasta z większą liczbą stacji
+    std::sort(matches.begin(), matches.end(), [](const CityMatch &a, const CityMatch &b) {
+        if (a.score != b.score) {
+            return a.score < b.score;
+        }
+        if (a.stationCount != b.stationCount) {
+            return a.stationCount > b.stationCount;
+        }
+        return a.city < b.city;
+    });
+
+    if (matches.size() > limit) {
+        matches.resize(limit);
+    }
+    return matches;
+}
+
+bool CitySearchIndex::resolveUnambiguous(const QString &query, CityMatch *match) const {
+    const QString key = StationCatalog::normalizeCity(query);
+    if (key.isEmpty() || m_entries.isEmpty()) {
+        return false;
+    }
+
+    const Entry *candidate = nullptr;
+
+    auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), key,
+                               [](const Entry &entry, const QString &k) { return entry.key < k; });
+    for (; it != m_entries.cend() && it->key.startsWith(key); ++it) {
+        if (candidate) {
+            return false;
+        }
+        candidate = &*it;
+    }
+
+    // Bez dopasowań prefiksowych - pojedyncza literówka, jak w search()
+    if (!candidate && key.size() >= 3) {
+        for (const Entry &entry : m_entries) {
+            const QStringView entryKey(entry.key);
+            if (boundedDistance(key, entryKey.left(key.size()), 1) > 1
+                && boundedDistance(key, entryKey, 1) > 1) {
+                continue;
+            }
+            if (candidate) {
+                return false;
+            }
+            candidate = &entry;
+        }
+    }
+
+    if (!candidate) {
+        return false;
+    }
+    match->city = candidate->city;
+    match->stationCount = candidate->stationCount;
+    match->score = 0;
+    return true;
+}
+
+int CitySearchIndex::boundedDistance(QStringView a, QStringView b, int maxDistance) {
+    const int n = int(a.size());
+    const int m = int(b.size());
+
+    if (qAbs(n - m) > maxDistance) {
+        return maxDistance + 1;
+    }
+
+    // Trzy wiersze macierzy (Damerau-Levenshtein w wersji "optimal string alignment")
+    QVarLengthArray<int, 64> rows(3 * (m + 1));
+    int *previous2 = rows.data();
+    int *previous = previous2 + (m + 1);
+    int *current = previous + (m + 1);
+
+    for (int j = 0; j <= m; ++j) {
+        previous[j] = j;
+    }
+
+    for (int i = 1; i <= n; ++i) {
+        current[0] = i;
+        int rowMinimum = current[0];
+
+        for (int j = 1; j <= m; ++j) {
+            const int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            int value = qMin(qMin(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+
+            // Zamiana sąsiednich liter
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                value = qMin(value, previous2[j - 2] + 1);
+            }
+
+            current[j] = value;
+            rowMinimum = qMin(rowMinimum, value);
+        }
+
+        // Cały wiersz przekracza limit - dalsze obliczenia nic nie zmienią
+        if (rowMinimum > maxDistance) {
+            return maxDistance + 1;
+        }
+
+        // Przesuwamy wiersze bez kopiowania
+        int *oldest = previous2;
+        previous2 = previous;
+        previous = current;
+        current = oldest;
+    }
+
+    return previous[m];
+}
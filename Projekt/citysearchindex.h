@@ -0,0 +1,47 @@
+#ifndef CITYSEARCHINDEX_H
+#define CITYSEARCHINDEX_H
+
+#include <QString>
+#include <QList>
+
+#include "stationcatalog.h"
+
+// Wynik wyszukiwania miasta
+struct CityMatch {
+    QString city;          // Nazwa miasta w oryginalnej pisowni
+    int stationCount = 0;  // Liczba stacji w mieście
+    int score = 0;         // Niższy wynik = lepsze dopasowanie
+};
+
+// Indeks nazw miast z katalogu stacji. Klucze są znormalizowane (małe litery,
+// bez polskich znaków) i posortowane, więc wyszukiwanie prefiksowe to
+// wyszukiwanie binarne. Gdy prefiks nie wystarcza, dopuszczamy literówki.
+class CitySearchIndex {
+public:
+    // Buduje indeks z listy stacji (jeden wpis na miasto)
+    void build(const QList<StationRecord> &stations);
+
+    // Zwraca najlepsze dopasowania posortowane od najlepszego
+    QList<CityMatch> search(const QString &query, int limit = 10) const;
+
+    // Jedyne miasto, o które może chodzić w zapytaniu bez dokładnego trafienia:
+    // jedyne dopasowanie prefiksowe albo, gdy takich nie ma, jedyne miasto
+    // z jedną literówką. Przy kilku kandydatach zwraca false.
+    bool resolveUnambiguous(const QString &query, CityMatch *match) const;
+
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+private:
+    struct Entry {
+        QString key;   // Znormalizowana nazwa miasta
+        QString city;  // Oryginalna nazwa
+        int stationCount = 0;
+    };
+
+    // Odległość Damerau-Levenshteina przerywana po przekroczeniu maxDistance
+    static int boundedDistance(QStringView a, QStringView b, int maxDistance);
+
+    QList<Entry> m_entries; // Posortowane po kluczu
+};
+
+#endif // CITYSEARCHINDEX_H
@@ -0,0 +1,87 @@
+#include "citysuggestionmodel.h"
+
+// Przerwa w pisaniu, po której uruchamiamy wyszukiwanie
+static const int DebounceIntervalMs = 120;
+// Maksymalna liczba podpowiedzi
+static const int MaxSuggestions = 8;
+
+CitySuggestionModel::CitySuggestionModel(const CitySearchIndex *index, QObject *parent)
+    : QAbstractListModel(parent),
+    m_index(index) {
+
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(DebounceIntervalMs);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &CitySuggestionModel::refresh);
+}
+
+int CitySuggestionModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_matches.size();
+}
+
+QVariant CitySuggestionModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_matches.size()) {
+        return QVariant();
+    }
+
+    const CityMatch &match = m_matches[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case CityRole:
+        return match.city;
+    case StationCountRole:
+        return match.stationCount;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> CitySuggestionModel::roleNames() const {
+    return {
+        {CityRole, "city"},
+        {StationCountRole, "stationCount"}
+    };
+}
+
+void CitySuggestionModel::setQuery(const QString &query) {
+    if (m_query == query) {
+        return;
+    }
+
+    m_query = query;
+    emit queryChanged();
+
+    // Wyszukujemy dopiero, gdy użytkownik przestanie pisać
+    m_debounceTimer.start();
+}
+
+void CitySuggestionModel::refresh() {
+    m_debounceTimer.stop();
+
+    const QList<CityMatch> matches = m_index ? m_index->search(m_query, MaxSuggestions) : QList<CityMatch>();
+
+    // Jedyna podpowiedź identyczna z zapytaniem nic nie wnosi
+    const bool onlyExact = matches.size() == 1 && matches.first().score == 0;
+
+    beginResetModel();
+    m_matches = onlyExact ? QList<CityMatch>() : matches;
+    endResetModel();
+
+    emit countChanged();
+}
+
+void CitySuggestionModel::clear() {
+    m_debounceTimer.stop();
+
+    if (m_matches.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    m_matches.clear();
+    endResetModel();
+
+    emit countChanged();
+}
@@ -0,0 +1,49 @@
+#ifndef CITYSUGGESTIONMODEL_H
+#define CITYSUGGESTIONMODEL_H
+
+#include <QAbstractListModel>
+#include <QTimer>
+
+#include "citysearchindex.h"
+
+// Podpowiedzi nazw miast w trakcie pisania. Zmiana zapytania uruchamia
+// wyszukiwanie dopiero po krótkiej przerwie w pisaniu (debouncing).
+class CitySuggestionModel : public QAbstractListModel {
+    Q_OBJECT
+    // Tekst wpisany przez użytkownika
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    // Liczba podpowiedzi
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        CityRole = Qt::UserRole + 1,
+        StationCountRole
+    };
+
+    explicit CitySuggestionModel(const CitySearchIndex *index, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString query() const { return m_query; }
+    void setQuery(const QString &query);
+
+    // Wyszukuje ponownie (np. po przebudowie indeksu)
+    void refresh();
+    // Czyści podpowiedzi bez czekania na przerwę w pisaniu
+    Q_INVOKABLE void clear();
+
+signals:
+    void queryChanged();
+    void countChanged();
+
+private:
+    const CitySearchIndex *m_index;
+    QString m_query;
+    QList<CityMatch> m_matches;
+    QTimer m_debounceTimer;
+};
+
+#endif // CITYSUGGESTIONMODEL_H
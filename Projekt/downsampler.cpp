@@ -0,0 +1,136 @@
+#include "downsampler.h"
+#include <cmath>
+
+namespace {
+
+// Gdy redukcja nie ma sensu, zwracamy wszystkie indeksy przedziału
+bool copyAllIfSmall(int first, int last, int threshold, QList<int> &indices) {
+    const int count = last - first;
+    if (count > threshold && threshold >= 3) {
+        return false;
+    }
+
+    indices.resize(qMax(0, count));
+    for (int i = 0; i < count; ++i) {
+        indices[i] = first + i;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace Downsampler {
+
+void largestTriangle(const TimeSeries &series, int first, int last, int threshold, QList<int> &indices) {
+    if (copyAllIfSmall(first, last, threshold, indices)) {
+        return;
+    }
+
+    // Czas liczymy względem pierwszego punktu, żeby nie tracić precyzji w double
+    const qint64 *timestamps = series.timestamps().constData();
+    const float *values = series.values().constData();
+    const qint64 origin = timestamps[first];
+
+    // Pierwszy i ostatni punkt są stałe; pozostałe dzielimy na threshold - 2 kubełki
+    const int count = last - first;
+    const int buckets = threshold - 2;
+    const double bucketSize = double(count - 2) / buckets;
+
+    indices.resize(threshold);
+    indices[0] = first;
+
+    int selected = first;
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        // Średnia następnego kubełka (dla ostatniego - sam ostatni punkt)
+        const int nextStart = first + int((bucket + 1) * bucketSize) + 1;
+        const int nextEnd = qMin(first + int((bucket + 2) * bucketSize) + 1, last);
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int i = nextStart; i < nextEnd; ++i) {
+            avgX += double(timestamps[i] - origin);
+            avgY += values[i];
+        }
+        const int nextCount = nextEnd - nextStart;
+        avgX /= nextCount;
+        avgY /= nextCount;
+
+        // Punkt bieżącego kubełka o największym polu trójkąta
+        const int rangeStart = first + int(bucket * bucketSize) + 1;
+        const int rangeEnd = first + int((bucket + 1) * bucketSize) + 1;
+        const double ax = double(timestamps[selected] - origin);
+        const double ay = values[selected];
+        const double dx = avgX - ax;
+        const double dy = avgY - ay;
+        // Podwojone pole trójkąta jest liniowe względem (x, y) punktu: |dx*y - dy*x + c|
+        const double c = dy * ax - dx * ay;
+
+        double maxArea = -1.0;
+        int best = rangeStart;
+        for (int i = rangeStart; i < rangeEnd; ++i) {
+            const double area = std::fabs(dx * values[i] - dy * double(timestamps[i] - origin) + c);
+            if (area > maxArea) {
+                maxArea = area;
+                best = i;
+            }
+        }
+
+        indices[bucket + 1] = best;
+        selected = best;
+    }
+
+    indices[threshold - 1] = last - 1;
+}
+
+void minMax(const TimeSeries &series, int first, int last, int threshold, QList<int> &indices) {
+    if (copyAllIfSmall(first, last, threshold, indices)) {
+        return;
+    }
+
+    const float *values = series.values().constData();
+
+    // Skrajne punkty zajmują dwa miejsca, każdy kubełek daje co najwyżej dwa
+    const int inner = last - first - 2;
+    const int buckets = qMax(1, (threshold - 2) / 2);
+    const double bucketSize = double(inner) / buckets;
+
+    indices.resize(0);
+    indices.append(first);
+
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        const int start = first + 1 + int(bucket * bucketSize);
+        const int end = bucket == buckets - 1 ? last - 1 : first + 1 + int((bucket + 1) * bucketSize);
+        if (start >= end) {
+            continue;
+        }
+
+        int minIndex = start;
+        int maxIndex = start;
+        float minValue = values[start];
+        float maxValue = minValue;
+        for (int i = start + 1; i < end; ++i) {
+            const float value = values[i];
+            if (value < minValue) {
+                minValue = value;
+                minIndex = i;
+            } else if (value > maxValue) {
+                maxValue = value;
+                maxIndex = i;
+            }
+        }
+
+        // Zachowujemy kolejność czasu, żeby linia nie cofała się w poziomie
+        if (minIndex == maxIndex) {
+            indices.append(minIndex);
+        } else if (minIndex < maxIndex) {
+            indices.append(minIndex);
+            indices.append(maxIndex);
+        } else {
+            indices.append(maxIndex);
+            indices.append(minIndex);
+        }
+    }
+
+    indices.append(last - 1);
+}
+
+} // namespace Downsampler
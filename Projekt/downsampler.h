@@ -0,0 +1,25 @@
+#ifndef DOWNSAMPLER_H
+#define DOWNSAMPLER_H
+
+#include <QList>
+
+#include "timeseries.h"
+
+// Redukcja liczby punktów serii przed rysowaniem. Obie metody zwracają indeksy
+// wybranych punktów z przedziału [first, last) w kolejności rosnącej; pierwszy
+// i ostatni punkt przedziału są zawsze zachowane. Bufor indices jest używany
+// ponownie, więc przy stałym rozmiarze wywołania nie alokują pamięci.
+namespace Downsampler {
+
+// Largest-Triangle-Three-Buckets: z każdego kubełka wybiera punkt tworzący
+// największy trójkąt z poprzednim wybranym punktem i średnią następnego kubełka.
+// Zwraca co najwyżej threshold punktów.
+void largestTriangle(const TimeSeries &series, int first, int last, int threshold, QList<int> &indices);
+
+// Minimum i maksimum w każdym kubełku (w kolejności czasu) - każdy skok wartości
+// pozostaje widoczny. Zwraca co najwyżej threshold punktów.
+void minMax(const TimeSeries &series, int first, int last, int threshold, QList<int> &indices);
+
+} // namespace Downsampler
+
+#endif // DOWNSAMPLER_H
@@ -0,0 +1,192 @@
+#include "giosclient.h"
+#include "responsecache.h"
+
+static const char ApiUrl[] = "https://api.gios.gov.pl/pjp-api/rest/";
+
+GiosClient::GiosClient(QObject *parent)
+    : QObject(parent),
+    m_networkManager(new QNetworkAccessManager(this)),
+    m_scheduler(new RequestScheduler(m_networkManager, this)),
+    m_parserThread(new QThread(this)),
+    m_parser(new ReplyParser) {
+
+    // Odpowiedzi API trafiają do dyskowej pamięci podręcznej - ponowne zapytania
+    // w czasie ważności nie wychodzą do sieci, później są sprawdzane warunkowo
+    m_networkManager->setCache(new ResponseCache(m_networkManager));
+
+    // Wszystkie żądania przechodzą przez kolejkę z priorytetami
+    connect(m_scheduler, &RequestScheduler::replyStarted, this, &GiosClient::onReplyStarted);
+    connect(m_scheduler, &RequestScheduler::replyFinished, this, &GiosClient::onNetworkReply);
+
+    // Odpowiedzi są parsowane w osobnym wątku; do wątku klienta wracają gotowe rekordy
+    m_parser->moveToThread(m_parserThread);
+    connect(m_parserThread, &QThread::finished, m_parser, &QObject::deleteLater);
+    connect(m_parser, &ReplyParser::parsed, this, &GiosClient::onReplyParsed);
+    m_parserThread->start();
+}
+
+GiosClient::~GiosClient() {
+    m_parserThread->quit();
+    m_parserThread->wait();
+    delete m_networkManager;
+}
+
+void GiosClient::fetchStationList(RequestScheduler::Priority priority) {
+    sendRequest(StationList, QUrl(QString(ApiUrl) + "station/findAll"), priority, "stations");
+}
+
+void GiosClient::fetchStationSensors(int stationId, RequestScheduler::Priority priority) {
+    sendRequest(StationDetails, QUrl(QString(ApiUrl) + QString("station/sensors/%1").arg(stationId)),
+                priority, "station", stationId);
+}
+
+void GiosClient::fetchSensorData(int sensorId, int stationId, RequestScheduler::Priority priority) {
+    sendRequest(SensorData, QUrl(QString(ApiUrl) + QString("data/getData/%1").arg(sensorId)),
+                priority, "station", sensorId, stationId);
+}
+
+void GiosClient::fetchSensorHistory(int sensorId, int stationId) {
+    sendRequest(SensorHistory, QUrl(QString(ApiUrl) + QString("data/getData/%1").arg(sensorId)),
+                RequestScheduler::Interactive, "history", sensorId, stationId);
+}
+
+void GiosClient::fetchAirQualityIndex(int stationId) {
+    sendRequest(AirQualityIndex, QUrl(QString(ApiUrl) + QString("aqindex/getIndex/%1").arg(stationId)),
+                RequestScheduler::Interactive, "airQuality", stationId);
+}
+
+void GiosClient::sendRequest(RequestType type, const QUrl &url, RequestScheduler::Priority priority,
+                             const QString &group, int targetId, int contextId) {
+    QNetworkRequest request(url);
+
+    // Każde żądanie niesie własny typ i identyfikatory - odpowiedź
+    // trafi do właściwej obsługi niezależnie od kolejności nadejścia
+    request.setAttribute(RequestTypeAttribute, static_cast<int>(type));
+    request.setAttribute(TargetIdAttribute, targetId);
+    request.setAttribute(ContextIdAttribute, contextId);
+
+    // Odpowiedź na żądanie sprzed anulowania grupy rozpoznamy po generacji
+    request.setAttribute(GroupAttribute, group);
+    request.setAttribute(GenerationAttribute, m_groupGenerations.value(group));
+
+    m_scheduler->enqueue(request, priority, group);
+}
+
+void GiosClient::cancelRequests(const QString &group) {
+    m_groupGenerations[group]++;
+    m_scheduler->cancelGroup(group);
+}
+
+bool GiosClient::isCurrentRequest(const QNetworkRequest &request) const {
+    const QString group = request.attribute(GroupAttribute).toString();
+    return request.attribute(GenerationAttribute).toUInt() == m_groupGenerations.value(group);
+}
+
+GiosClient::RequestType GiosClient::requestType(const QNetworkRequest &request) {
+    return static_cast<RequestType>(request.attribute(RequestTypeAttribute).toInt());
+}
+
+int GiosClient::requestTargetId(const QNetworkRequest &request) {
+    return request.attribute(TargetIdAttribute).toInt();
+}
+
+int GiosClient::requestContextId(const QNetworkRequest &request) {
+    return request.attribute(ContextIdAttribute).toInt();
+}
+
+void GiosClient::onNetworkReply(QNetworkReply *reply, const QList<QNetworkRequest> &requests) {
+    // Żądania z grup anulowanych po ich wysłaniu pomijamy bez czytania
+    // i parsowania odpowiedzi
+    ParsedReply parsed;
+    for (const QNetworkRequest &request : requests) {
+        if (isCurrentRequest(request)) {
+            parsed.requests.append(request);
+        }
+    }
+    if (parsed.requests.isEmpty()) {
+        reply->deleteLater();
+        return;
+    }
+
+    // Wszystkie żądania odpowiedzi mają ten sam adres, więc i rodzaj treści
+    switch (requestType(parsed.requests.first())) {
+    case StationList:
+        parsed.kind = ParsedReply::StationList;
+        break;
+    case StationDetails:
+        parsed.kind = ParsedReply::StationSensors;
+        break;
+    case SensorData:
+    case SensorHistory:
+        parsed.kind = ParsedReply::SensorValues;
+        break;
+    case AirQualityIndex:
+        parsed.kind = ParsedReply::AirQualityIndex;
+        break;
+    }
+
+    parsed.error = reply->error();
+    parsed.errorString = reply->errorString();
+    if (parsed.kind == ParsedReply::StationList) {
+        parsed.stream = quintptr(reply);
+    }
+    // Dla strumienia to tylko ostatni, jeszcze nieprzeczytany fragment
+    const QByteArray body = parsed.error == QNetworkReply::NoError ? reply->readAll() : QByteArray();
+    reply->deleteLater();
+
+    // Parsowanie i budowanie rekordów odbywa się w wątku parsera
+    ReplyParser *parser = m_parser;
+    QMetaObject::invokeMethod(parser, [parser, parsed, body]() {
+        parser->parse(parsed, body);
+    }, Qt::QueuedConnection);
+}
+
+void GiosClient::onReplyStarted(QNetworkReply *reply, const QNetworkRequest &request) {
+    if (requestType(request) != StationList) {
+        return;
+    }
+
+    // Katalog stacji czytamy w trakcie pobierania: każdy fragment od razu trafia
+    // do wątku parsera, więc w pamięci nie czeka cała odpowiedź
+    ReplyParser *parser = m_parser;
+    const quintptr stream = quintptr(reply);
+    connect(reply, &QNetworkReply::readyRead, this, [parser, reply, stream]() {
+        const QByteArray chunk = reply->readAll();
+        QMetaObject::invokeMethod(parser, [parser, stream, chunk]() {
+            parser->feedStream(stream, chunk);
+        }, Qt::QueuedConnection);
+    });
+
+    // Odpowiedź anulowana lub pominięta nie dotrze do parse() - zwalniamy strumień
+    connect(reply, &QObject::destroyed, parser, [parser, stream]() {
+        parser->discardStream(stream);
+    });
+}
+
+void GiosClient::onReplyParsed(const ParsedReply &reply) {
+    for (const QNetworkRequest &request : reply.requests) {
+        // Grupa mogła zostać anulowana w trakcie parsowania
+        if (!isCurrentRequest(request)) {
+            continue;
+        }
+
+        // Rodzaj zapytania odczytujemy z żądania, do którego należy odpowiedź
+        switch (requestType(request)) {
+        case StationList:
+            emit stationListReceived(reply);
+            break;
+        case StationDetails:
+            emit stationSensorsReceived(requestTargetId(request), reply);
+            break;
+        case SensorData:
+            emit sensorDataReceived(requestTargetId(request), requestContextId(request), reply);
+            break;
+        case SensorHistory:
+            emit sensorHistoryReceived(requestTargetId(request), requestContextId(request), reply);
+            break;
+        case AirQualityIndex:
+            emit airQualityReceived(requestTargetId(request), reply);
+            break;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef GIOSCLIENT_H
+#define GIOSCLIENT_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QThread>
+#include <QUrl>
+
+#include "requestscheduler.h"
+#include "replyparser.h"
+
+// Klient API GIOŚ bez interfejsu użytkownika: buduje zapytania, wysyła je przez
+// kolejkę z priorytetami (z dyskową pamięcią podręczną odpowiedzi) i parsuje
+// odpowiedzi w osobnym wątku. Gotowe rekordy wracają sygnałami. Używa go okno
+// aplikacji (MainWindow) oraz tryby bez QML (--headless): wsadowy i demon odświeżania.
+class GiosClient : public QObject {
+    Q_OBJECT
+
+public:
+    explicit GiosClient(QObject *parent = nullptr);
+    ~GiosClient();
+
+    RequestScheduler *scheduler() const { return m_scheduler; }
+
+    // Zapytania do API. Grupa żądania w kolejce wynika z jego rodzaju:
+    // "stations" - katalog, "station" - czujniki stacji i ich pomiary,
+    // "history" - historia wybranego czujnika, "airQuality" - indeks jakości powietrza.
+    // Priorytet można obniżyć dla pobierania w tle (np. PollingCollector)
+    void fetchStationList(RequestScheduler::Priority priority = RequestScheduler::Normal);
+    void fetchStationSensors(int stationId, RequestScheduler::Priority priority = RequestScheduler::Interactive);
+    // Pomiary jednego z czujników stacji (pobieranie wszystkich czujników stacji)
+    void fetchSensorData(int sensorId, int stationId, RequestScheduler::Priority priority = RequestScheduler::Normal);
+    // Pomiary czujnika wybranego przez użytkownika - wyższy priorytet niż fetchSensorData()
+    void fetchSensorHistory(int sensorId, int stationId);
+    void fetchAirQualityIndex(int stationId);
+
+    // Anuluje żądania grupy; odpowiedzi, które mimo to nadejdą, są pomijane bez parsowania
+    void cancelRequests(const QString &group);
+
+signals:
+    // Odpowiedzi na żądania z grup, które nie zostały anulowane - także z błędem
+    // sieci (reply.error). Odpowiedź wspólna dla kilku żądań jest parsowana raz,
+    // a sygnał jest emitowany dla każdego z nich.
+    void stationListReceived(const ParsedReply &reply);
+    void stationSensorsReceived(int stationId, const ParsedReply &reply);
+    void sensorDataReceived(int sensorId, int stationId, const ParsedReply &reply);
+    void sensorHistoryReceived(int sensorId, int stationId, const ParsedReply &reply);
+    void airQualityReceived(int stationId, const ParsedReply &reply);
+
+private slots:
+    // Odpowiedź z kolejki - requests to wszystkie żądania obsłużone tą jedną odpowiedzią
+    void onNetworkReply(QNetworkReply *reply, const QList<QNetworkRequest> &requests);
+    // Początek pobierania - katalog stacji jest parsowany w trakcie
+    void onReplyStarted(QNetworkReply *reply, const QNetworkRequest &request);
+    // Gotowe rekordy z wątku parsowania
+    void onReplyParsed(const ParsedReply &reply);
+
+private:
+    // Typ zapytania - zapisywany w samym żądaniu, dzięki czemu wiele zapytań
+    // może być w toku jednocześnie
+    enum RequestType {
+        StationList,
+        StationDetails,
+        SensorData,
+        SensorHistory,
+        AirQualityIndex
+    };
+
+    // Atrybuty żądania: typ, ID celu (stacja/czujnik) oraz ID kontekstu
+    // (np. stacja, do której należy czujnik)
+    static constexpr QNetworkRequest::Attribute RequestTypeAttribute = QNetworkRequest::User;
+    static constexpr QNetworkRequest::Attribute TargetIdAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+    static constexpr QNetworkRequest::Attribute ContextIdAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 2);
+    // Grupa żądania w kolejce i jej generacja w chwili wysłania
+    static constexpr QNetworkRequest::Attribute GroupAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 3);
+    static constexpr QNetworkRequest::Attribute GenerationAttribute =
+        static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 4);
+
+    // Wysyła żądanie GET oznaczone typem i identyfikatorami przez kolejkę
+    void sendRequest(RequestType type, const QUrl &url, RequestScheduler::Priority priority,
+                     const QString &group, int targetId = 0, int contextId = 0);
+    // Czy żądanie należy do bieżącej generacji swojej grupy
+    bool isCurrentRequest(const QNetworkRequest &request) const;
+    static RequestType requestType(const QNetworkRequest &request);
+    static int requestTargetId(const QNetworkRequest &request);
+    static int requestContextId(const QNetworkRequest &request);
+
+    QNetworkAccessManager *m_networkManager;
+    RequestScheduler *m_scheduler;              // Kolejka żądań z priorytetami
+    QThread *m_parserThread;                    // Wątek parsowania odpowiedzi
+    ReplyParser *m_parser;                      // Parser odpowiedzi (żyje w m_parserThread)
+    QHash<QString, quint32> m_groupGenerations; // Generacje grup żądań (zwiększane przy anulowaniu)
+};
+
+#endif // GIOSCLIENT_H
@@ -0,0 +1,148 @@
+#include "giosdate.h"
+#include <QDateTime>
+#include <QTimeZone>
+
+namespace GiosDate {
+
+static const qint64 MsPerHour = 60 * 60 * 1000;
+static const qint64 MsPerDay = 24 * MsPerHour;
+
+// Lata, w których czas letni w Polsce wynika z reguły UE: od ostatniej niedzieli
+// marca do ostatniej niedzieli października, zmiana zegarów o 1:00 UTC.
+// Daty spoza zakresu (wcześniejsze reguły) przelicza QTimeZone.
+static const int RuleFirstYear = 1996;
+static const int RuleLastYear = 2099;
+
+// Strefa czasowa, w której API podaje daty
+static const QTimeZone &warsawZone() {
+    static const QTimeZone zone("Europe/Warsaw");
+    return zone;
+}
+
+// Liczba dni od 1970-01-01 do daty w kalendarzu gregoriańskim
+static qint64 daysFromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return qint64(era) * 146097 + dayOfEra - 719468;
+}
+
+static int daysInMonth(int year, int month) {
+    static const int Days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : Days[month - 1];
+}
+
+// Ostatnia niedziela miesiąca w dniach od epoki (1970-01-01 był czwartkiem)
+static qint64 lastSunday(int year, int month) {
+    const qint64 last = daysFromCivil(year, month, daysInMonth(year, month));
+    return last - (last + 4) % 7;
+}
+
+// Ostatnio przeliczony dzień. Kolejne daty w odpowiedzi należą zwykle do tego
+// samego dnia (pomiary godzinowe), więc kalendarz i granice czasu letniego są
+// liczone raz na dzień. Osobna kopia dla każdego wątku - bez blokad.
+struct DayCache {
+    int key = 0;               // yyyymmdd
+    int year = 0;
+    qint64 dayMs = 0;          // Północ czasu polskiego zapisana tak, jakby była w UTC
+    qint64 summerBeginMs = 0;  // Czas letni: [summerBeginMs, summerEndMs), w tym samym zapisie
+    qint64 summerEndMs = 0;
+};
+
+static thread_local DayCache dayCache;
+
+// Milisekundy od epoki dla czasu polskiego z zakresu reguły UE. Godzinę z przestawienia
+// zegarów (nieistniejące 2:xx w marcu, podwójne 2:xx w październiku) liczymy
+// z przesunięciem sprzed zmiany - tak jak QDateTime.
+static qint64 warsawToUtc(int year, int month, int day, int hour, int minute, int second) {
+    DayCache &cache = dayCache;
+    const int key = (year * 100 + month) * 100 + day;
+    if (cache.key != key) {
+        if (cache.year != year) {
+            cache.year = year;
+            cache.summerBeginMs = lastSunday(year, 3) * MsPerDay + 3 * MsPerHour;
+            cache.summerEndMs = lastSunday(year, 10) * MsPerDay + 3 * MsPerHour;
+        }
+        cache.key = key;
+        cache.dayMs = daysFromCivil(year, month, day) * MsPerDay;
+    }
+
+    const qint64 local = cache.dayMs + ((hour * 60 + minute) * 60 + second) * qint64(1000);
+    const bool summer = local >= cache.summerBeginMs && local < cache.summerEndMs;
+    return local - (summer ? 2 : 1) * MsPerHour;
+}
+
+// Odczytuje liczbę z count cyfr zaczynając od pozycji pos
+template <typename Char>
+static bool readNumber(const Char *text, int pos, int count, int *result) {
+    int value = 0;
+    for (int i = pos; i < pos + count; ++i) {
+        const Char ch = text[i];
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        value = value * 10 + int(ch - '0');
+    }
+    *result = value;
+    return true;
+}
+
+// Wspólne parsowanie dla tekstu UTF-16 i bajtów z odpowiedzi - bez alokacji
+template <typename Char>
+static qint64 parseChars(const Char *text, qsizetype size, bool *ok) {
+    if (ok) {
+        *ok = false;
+    }
+
+    // Format stały: yyyy-MM-dd HH:mm:ss (19 znaków)
+    if (size < 19 || text[4] != '-' || text[7] != '-' || text[10] != ' '
+        || text[13] != ':' || text[16] != ':') {
+        return 0;
+    }
+
+    int year, month, day, hour, minute, second;
+    if (!readNumber(text, 0, 4, &year) || !readNumber(text, 5, 2, &month) || !readNumber(text, 8, 2, &day)
+        || !readNumber(text, 11, 2, &hour) || !readNumber(text, 14, 2, &minute) || !readNumber(text, 17, 2, &second)) {
+        return 0;
+    }
+
+    if (month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 || second > 59) {
+        return 0;
+    }
+
+    qint64 result;
+    if (year >= RuleFirstYear && year <= RuleLastYear) {
+        if (day > daysInMonth(year, month)) {
+            return 0;
+        }
+        result = warsawToUtc(year, month, day, hour, minute, second);
+    } else {
+        const QDate date(year, month, day);
+        if (!date.isValid()) {
+            return 0;
+        }
+        result = QDateTime(date, QTime(hour, minute, second), warsawZone()).toMSecsSinceEpoch();
+    }
+
+    if (ok) {
+        *ok = true;
+    }
+    return result;
+}
+
+qint64 parse(QStringView text, bool *ok) {
+    return parseChars(text.utf16(), text.size(), ok);
+}
+
+qint64 parse(QByteArrayView text, bool *ok) {
+    return parseChars(text.data(), text.size(), ok);
+}
+
+QString format(qint64 msecsSinceEpoch) {
+    return QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch, warsawZone()).toString("yyyy-MM-dd HH:mm:ss");
+}
+
+} // namespace GiosDate
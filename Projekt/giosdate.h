@@ -0,0 +1,23 @@
+#ifndef GIOSDATE_H
+#define GIOSDATE_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+// Daty w API GIOŚ mają stały format "yyyy-MM-dd HH:mm:ss" i są podawane
+// w czasie polskim. Funkcje zamieniają je na milisekundy od epoki (UTC) i z powrotem.
+namespace GiosDate {
+
+// Zwraca milisekundy od epoki; przy błędnym formacie ustawia *ok na false i zwraca 0.
+// Nie alokuje pamięci - czas letni liczy według reguły UE, bez QDateTime.
+qint64 parse(QStringView text, bool *ok = nullptr);
+// To samo dla bajtów odpowiedzi (ASCII), bez zamiany na QString
+qint64 parse(QByteArrayView text, bool *ok = nullptr);
+
+// Formatuje czas jako "yyyy-MM-dd HH:mm:ss" w czasie polskim
+QString format(qint64 msecsSinceEpoch);
+
+} // namespace GiosDate
+
+#endif // GIOSDATE_H
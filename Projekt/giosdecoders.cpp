@@ -0,0 +1,280 @@
+#include "giosdecoders.h"
+#include "giosdate.h"
+#include "jsontokenizer.h"
+
+namespace {
+
+// Pomiar getData w zapisie JSON ma ok. 48 bajtów - wstępna rezerwacja serii
+const int BytesPerValue = 48;
+
+enum SensorField {
+    SensorOther,
+    SensorId,
+    SensorParam
+};
+
+enum ParamField {
+    ParamOther,
+    ParamName,
+    ParamCode,
+    ParamFormula
+};
+
+enum ValuesField {
+    ValuesOther,
+    ValuesKey,
+    ValuesList
+};
+
+enum PointField {
+    PointOther,
+    PointDate,
+    PointValue
+};
+
+enum IndexField {
+    IndexOther,
+    IndexStation,
+    IndexPm10
+};
+
+ParamField paramFieldFor(QByteArrayView key) {
+    if (key == "paramName") {
+        return ParamName;
+    }
+    if (key == "paramCode") {
+        return ParamCode;
+    }
+    if (key == "paramFormula") {
+        return ParamFormula;
+    }
+    return ParamOther;
+}
+
+} // namespace
+
+namespace GiosDecoders {
+
+bool decodeStationSensors(QByteArrayView body, QList<SensorReading> *sensors) {
+    // Układ: tablica czujników (głębokość 2), w nich obiekt "param" (głębokość 3)
+    JsonTokenizer tokenizer;
+    tokenizer.setData(body);
+    if (tokenizer.next() != JsonTokenizer::BeginArray) {
+        return false;
+    }
+
+    SensorReading current;
+    SensorField field = SensorOther;
+    ParamField paramField = ParamOther;
+    bool inParam = false;
+
+    for (;;) {
+        const JsonTokenizer::Token token = tokenizer.next();
+        const int depth = tokenizer.depth();
+
+        switch (token) {
+        case JsonTokenizer::EndOfData:
+            return true;
+        case JsonTokenizer::NeedMoreData:
+        case JsonTokenizer::Error:
+            return false;
+        case JsonTokenizer::BeginObject:
+            if (depth == 2) {
+                current = SensorReading();
+                current.position = sensors->size();
+                field = SensorOther;
+            } else if (depth == 3) {
+                inParam = field == SensorParam;
+                paramField = ParamOther;
+            }
+            break;
+        case JsonTokenizer::EndObject:
+            if (depth == 1) {
+                sensors->append(current);
+            } else if (depth == 2) {
+                inParam = false;
+            }
+            break;
+        case JsonTokenizer::Key:
+            if (depth == 2) {
+                const QByteArrayView key = tokenizer.text();
+                field = key == "id" ? SensorId : key == "param" ? SensorParam : SensorOther;
+            } else if (depth == 3 && inParam) {
+                paramField = paramFieldFor(tokenizer.text());
+            }
+            break;
+        case JsonTokenizer::Number:
+            if (depth == 2 && field == SensorId) {
+                current.sensorId = int(tokenizer.number());
+            }
+            break;
+        case JsonTokenizer::String:
+            if (depth == 3 && inParam) {
+                switch (paramField) {
+                case ParamName:
+                    current.param = tokenizer.string();
+                    break;
+                case ParamCode:
+                    current.paramCode = tokenizer.string();
+                    break;
+                case ParamFormula:
+                    current.paramFormula = tokenizer.string();
+                    break;
+                case ParamOther:
+                    break;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool decodeSensorValues(QByteArrayView body, TimeSeries *series) {
+    // Układ: obiekt z polami "key" i "values", pomiary na głębokości 3
+    JsonTokenizer tokenizer;
+    tokenizer.setData(body);
+    if (tokenizer.next() != JsonTokenizer::BeginObject) {
+        return false;
+    }
+
+    series->reserve(int(body.size() / BytesPerValue));
+
+    ValuesField field = ValuesOther;
+    PointField pointField = PointOther;
+    bool inValues = false;
+    qint64 timestamp = 0;
+    bool dateOk = false;
+    double value = -1.0;
+
+    for (;;) {
+        const JsonTokenizer::Token token = tokenizer.next();
+        const int depth = tokenizer.depth();
+
+        switch (token) {
+        case JsonTokenizer::EndOfData:
+            // API zwraca pomiary od najnowszych - seria jest trzymana rosnąco
+            series->sortByTime();
+            return true;
+        case JsonTokenizer::NeedMoreData:
+        case JsonTokenizer::Error:
+            return false;
+        case JsonTokenizer::BeginArray:
+            inValues = depth == 2 && field == ValuesList;
+            break;
+        case JsonTokenizer::EndArray:
+            if (depth == 1) {
+                inValues = false;
+            }
+            break;
+        case JsonTokenizer::BeginObject:
+            if (depth == 3 && inValues) {
+                pointField = PointOther;
+                dateOk = false;
+                value = -1.0;
+            }
+            break;
+        case JsonTokenizer::EndObject:
+            // Wartość null lub ujemna i błędna data - pomiar pomijamy
+            if (depth == 2 && inValues && dateOk && value >= 0) {
+                series->append(timestamp, float(value));
+            }
+            break;
+        case JsonTokenizer::Key:
+            if (depth == 1) {
+                const QByteArrayView key = tokenizer.text();
+                field = key == "key" ? ValuesKey : key == "values" ? ValuesList : ValuesOther;
+            } else if (depth == 3 && inValues) {
+                const QByteArrayView key = tokenizer.text();
+                pointField = key == "date" ? PointDate : key == "value" ? PointValue : PointOther;
+            }
+            break;
+        case JsonTokenizer::String:
+            if (depth == 1 && field == ValuesKey) {
+                series->info().unit = tokenizer.string();
+            } else if (depth == 3 && inValues && pointField == PointDate) {
+                // Data jest zamieniana prosto z bajtów odpowiedzi
+                timestamp = GiosDate::parse(tokenizer.text(), &dateOk);
+            }
+            break;
+        case JsonTokenizer::Number:
+            if (depth == 3 && inValues && pointField == PointValue) {
+                bool ok = false;
+                value = tokenizer.number(&ok);
+                if (!ok) {
+                    value = -1.0;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool decodeAirQualityIndex(QByteArrayView body, bool *hasData, QString *indexLevel) {
+    // Układ: obiekt z polami indeksów, każdy indeks to obiekt z "indexLevelName"
+    JsonTokenizer tokenizer;
+    tokenizer.setData(body);
+    *hasData = false;
+    if (tokenizer.next() != JsonTokenizer::BeginObject) {
+        return false;
+    }
+
+    IndexField field = IndexOther;
+    bool levelName = false;
+    bool stationIndex = false;
+    bool pm10Index = false;
+    QString stationLevel;
+    QString pm10Level;
+
+    for (;;) {
+        const JsonTokenizer::Token token = tokenizer.next();
+        const int depth = tokenizer.depth();
+
+        switch (token) {
+        case JsonTokenizer::EndOfData:
+            // Ogólny indeks stacji, a gdy go brak - indeks PM10
+            if (stationIndex) {
+                *indexLevel = stationLevel;
+            } else if (pm10Index) {
+                *indexLevel = pm10Level;
+            }
+            return true;
+        case JsonTokenizer::NeedMoreData:
+        case JsonTokenizer::Error:
+            return false;
+        case JsonTokenizer::BeginObject:
+            if (depth == 2) {
+                stationIndex = stationIndex || field == IndexStation;
+                pm10Index = pm10Index || field == IndexPm10;
+                levelName = false;
+            }
+            break;
+        case JsonTokenizer::Key:
+            if (depth == 1) {
+                *hasData = true;
+                const QByteArrayView key = tokenizer.text();
+                field = key == "stIndexLevel" ? IndexStation : key == "pm10IndexLevel" ? IndexPm10 : IndexOther;
+                levelName = false;
+            } else if (depth == 2) {
+                levelName = tokenizer.text() == "indexLevelName";
+            }
+            break;
+        case JsonTokenizer::String:
+            if (depth == 2 && levelName) {
+                if (field == IndexStation) {
+                    stationLevel = tokenizer.string();
+                } else if (field == IndexPm10) {
+                    pm10Level = tokenizer.string();
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+} // namespace GiosDecoders
@@ -0,0 +1,31 @@
+#ifndef GIOSDECODERS_H
+#define GIOSDECODERS_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+#include "sensordatamodel.h"
+#include "timeseries.h"
+
+// Dekodery odpowiedzi API GIOŚ pisane pod konkretny układ pól. Czytają surowe
+// bajty odpowiedzi tokenizerem (bez kopiowania i bez drzewa QJsonDocument),
+// daty i liczby zamieniają w miejscu i zapisują wynik od razu do struktur.
+// Nieznane pola są pomijane. Przy błędzie składni zwracają false.
+namespace GiosDecoders {
+
+// station/sensors/{id}: [{"id", "param": {"paramName", "paramFormula", "paramCode"}}]
+// position - kolejność czujnika w odpowiedzi
+bool decodeStationSensors(QByteArrayView body, QList<SensorReading> *sensors);
+
+// data/getData/{id}: {"key", "values": [{"date", "value"}]}
+// Pomija wartości null i ujemne oraz błędne daty; seria jest posortowana rosnąco
+bool decodeSensorValues(QByteArrayView body, TimeSeries *series);
+
+// aqindex/getIndex/{id}: nazwa poziomu z "stIndexLevel", a gdy go brak - z "pm10IndexLevel".
+// *hasData - czy odpowiedź jest niepustym obiektem
+bool decodeAirQualityIndex(QByteArrayView body, bool *hasData, QString *indexLevel);
+
+} // namespace GiosDecoders
+
+#endif // GIOSDECODERS_H
@@ -0,0 +1,114 @@
+#include "headless.h"
+#include "batchcollector.h"
+#include "pollingcollector.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+namespace Headless {
+
+int run(const QStringList &arguments) {
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Pobieranie pomiarów GIOŚ bez interfejsu użytkownika.");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    const QCommandLineOption headlessOption("headless", "Tryb bez interfejsu użytkownika.");
+    const QCommandLineOption daemonOption("daemon", "Stałe odświeżanie stacji co godzinę (wyniki w lokalnej historii).");
+    const QCommandLineOption allOption("all", "Wszystkie stacje z katalogu.");
+    const QCommandLineOption cityOption("city", "Pomiary wszystkich stacji w mieście.", "nazwa");
+    const QCommandLineOption stationOption("station", "Pomiary wszystkich czujników stacji.", "id");
+    const QCommandLineOption sensorOption("sensor", "Pomiary czujnika.", "id");
+    const QCommandLineOption jobsOption("jobs", "Plik zadań (wiersze: city <nazwa>, station <id>, sensor <id>, all).", "plik");
+    const QCommandLineOption outputOption("output", "Wyniki: store - lokalna historia (domyślnie), stdout - JSON.",
+                                          "cel", "store");
+    const QCommandLineOption jitterOption("jitter", "Losowe przesunięcie przebiegu po pełnej godzinie (--daemon).",
+                                          "minuty", "10");
+    parser.addOptions({headlessOption, daemonOption, allOption, cityOption, stationOption, sensorOption,
+                       jobsOption, outputOption, jitterOption});
+
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << '\n';
+        return 2;
+    }
+    if (parser.isSet(helpOption)) {
+        parser.showHelp(0);
+    }
+
+    CollectorJobs jobs;
+    jobs.allStations = parser.isSet(allOption);
+    jobs.cities = parser.values(cityOption);
+    for (const QString &value : parser.values(stationOption)) {
+        bool ok = false;
+        const int id = value.toInt(&ok);
+        if (!ok) {
+            err << "Niepoprawny numer stacji: " << value << '\n';
+            return 2;
+        }
+        jobs.stations.append(id);
+    }
+    for (const QString &value : parser.values(sensorOption)) {
+        bool ok = false;
+        const int id = value.toInt(&ok);
+        if (!ok) {
+            err << "Niepoprawny numer czujnika: " << value << '\n';
+            return 2;
+        }
+        jobs.sensors.append(id);
+    }
+    for (const QString &path : parser.values(jobsOption)) {
+        QString error;
+        if (!jobs.readFile(path, &error)) {
+            err << error << '\n';
+            return 2;
+        }
+    }
+    if (jobs.isEmpty()) {
+        err << "Brak zadań - podaj --all, --city, --station, --sensor lub --jobs\n";
+        return 2;
+    }
+
+    const QString output = parser.value(outputOption);
+    if (output != "store" && output != "stdout") {
+        err << "Niepoprawna wartość --output: " << output << " (store lub stdout)\n";
+        return 2;
+    }
+
+    // Klient i historia wspólne dla obu trybów; historia leży w tym samym
+    // katalogu co w oknie aplikacji
+    GiosClient client;
+    HistoryStore historyStore;
+
+    if (parser.isSet(daemonOption)) {
+        if (output != "store") {
+            err << "Tryb --daemon zapisuje pomiary tylko w lokalnej historii (--output store)\n";
+            return 2;
+        }
+        bool ok = false;
+        const int jitterMinutes = parser.value(jitterOption).toInt(&ok);
+        if (!ok || jitterMinutes < 0 || jitterMinutes > 50) {
+            err << "Niepoprawna wartość --jitter: " << parser.value(jitterOption) << " (0-50 minut)\n";
+            return 2;
+        }
+
+        PollingCollector collector(&client, &historyStore);
+        collector.setJobs(jobs);
+        collector.setJitter(jitterMinutes * 60 * 1000);
+        collector.start();
+        return QCoreApplication::exec();
+    }
+
+    BatchCollector collector(&client, &historyStore);
+    collector.setJobs(jobs);
+    collector.setOutput(output == "stdout" ? BatchCollector::StdoutOutput : BatchCollector::StoreOutput);
+
+    // Zakończenie może nastąpić jeszcze przed uruchomieniem pętli zdarzeń
+    QObject::connect(&collector, &BatchCollector::finished, QCoreApplication::instance(),
+                     [](int exitCode) {
+                         QCoreApplication::exit(exitCode);
+                     }, Qt::QueuedConnection);
+    collector.start();
+    return QCoreApplication::exec();
+}
+
+} // namespace Headless
@@ -0,0 +1,16 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <QStringList>
+
+// Tryby bez okna i bez silnika QML (stacje_pomiarowe --headless):
+//  - jednorazowe pobranie pomiarów dla zadań (BatchCollector),
+//  - z --daemon stałe, cogodzinne odświeżanie obserwowanych stacji (PollingCollector).
+// Zwraca kod wyjścia: 0 - sukces, 1 - część zadań się nie powiodła, 2 - błędne argumenty.
+namespace Headless {
+
+int run(const QStringList &arguments);
+
+} // namespace Headless
+
+#endif // HEADLESS_H
@@ -0,0 +1,371 @@
+#include "historystore.h"
+#include "seriescodec.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+// Po tylu punktach w dzienniku przepisujemy historię do pliku .dat
+static const int CompactionThreshold = 512;
+// Maksymalny czas oczekiwania na blokadę plików czujnika
+static const int LockTimeoutMs = 5000;
+
+// Nagłówek pliku .dat: znacznik i wersja formatu.
+// Wersja 1: liczba punktów i surowe punkty; wersja 2: seria skompresowana SeriesCodec.
+static const char DataMagic[4] = {'S', 'H', 'S', 'T'};
+static const quint32 RawDataVersion = 1;
+static const quint32 CompressedDataVersion = 2;
+static const int DataHeaderSize = 8;
+// Punkt w plikach: znacznik czasu (int64) i wartość (float32), little-endian
+static const int RecordSize = 12;
+
+namespace {
+
+void appendRecord(QByteArray &bytes, qint64 timestamp, float value) {
+    quint32 valueBits;
+    std::memcpy(&valueBits, &value, sizeof(valueBits));
+
+    char record[RecordSize];
+    qToLittleEndian<qint64>(timestamp, record);
+    qToLittleEndian<quint32>(valueBits, record + 8);
+    bytes.append(record, RecordSize);
+}
+
+// Dopisuje do serii punkty zapisane jeden po drugim
+void readRecords(const char *data, qsizetype size, TimeSeries &series) {
+    const qsizetype count = size / RecordSize;
+    series.reserve(series.size() + int(count));
+    for (qsizetype i = 0; i < count; ++i) {
+        const char *record = data + i * RecordSize;
+        const quint32 valueBits = qFromLittleEndian<quint32>(record + 8);
+        float value;
+        std::memcpy(&value, &valueBits, sizeof(value));
+        series.append(qFromLittleEndian<qint64>(record), value);
+    }
+}
+
+QByteArray encodeData(const TimeSeries &series) {
+    QByteArray bytes;
+    bytes.append(DataMagic, sizeof(DataMagic));
+
+    char version[4];
+    qToLittleEndian<quint32>(CompressedDataVersion, version);
+    bytes.append(version, sizeof(version));
+
+    bytes.append(SeriesCodec::encode(series));
+    return bytes;
+}
+
+bool decodeData(const QByteArray &bytes, TimeSeries &series) {
+    if (bytes.size() < DataHeaderSize || std::memcmp(bytes.constData(), DataMagic, sizeof(DataMagic)) != 0) {
+        return false;
+    }
+
+    const quint32 version = qFromLittleEndian<quint32>(bytes.constData() + 4);
+    const char *payload = bytes.constData() + DataHeaderSize;
+    const qsizetype payloadSize = bytes.size() - DataHeaderSize;
+
+    if (version == CompressedDataVersion) {
+        return SeriesCodec::decode(payload, payloadSize, series);
+    }
+
+    // Pliki zapisane przed wprowadzeniem kompresji
+    if (version == RawDataVersion && payloadSize >= 4) {
+        const quint32 count = qFromLittleEndian<quint32>(payload);
+        if (payloadSize - 4 >= qsizetype(count) * RecordSize) {
+            readRecords(payload + 4, qsizetype(count) * RecordSize, series);
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray readFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+} // namespace
+
+HistoryStore::HistoryStore(QObject *parent)
+    : HistoryStore(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/history", parent) {
+}
+
+HistoryStore::HistoryStore(const QString &directory, QObject *parent)
+    : QObject(parent),
+    m_directory(directory) {
+
+    QDir().mkpath(m_directory);
+
+    // Kompaktowania wykonujemy po kolei, żeby nie konkurowały o dysk
+    m_compactionPool.setMaxThreadCount(1);
+}
+
+HistoryStore::~HistoryStore() {
+    waitForCompaction();
+}
+
+QString HistoryStore::filePath(int sensorId, const QString &suffix) const {
+    return QString("%1/%2.%3").arg(m_directory).arg(sensorId).arg(suffix);
+}
+
+TimeSeries HistoryStore::load(int sensorId) {
+    return state(sensorId).series;
+}
+
+qint64 HistoryStore::lastFetched(int sensorId) {
+    return state(sensorId).lastFetched;
+}
+
+void HistoryStore::releaseSeries() {
+    // Stan kompaktowanych czujników zostaje do końca kompaktowania
+    m_sensors.removeIf([](const QHash<int, SensorState>::iterator it) {
+        return !it->compacting;
+    });
+}
+
+HistoryStore::SensorState &HistoryStore::state(int sensorId) {
+    auto it = m_sensors.find(sensorId);
+    if (it == m_sensors.end()) {
+        it = m_sensors.insert(sensorId, SensorState());
+        readSensor(sensorId, it.value());
+
+        // Dziennik pozostały po przerwanym kompaktowaniu
+        if (QFile::exists(filePath(sensorId, "log.compacting"))) {
+            scheduleCompaction(sensorId);
+        }
+    } else if (it->diskStamp != diskStamp(sensorId)) {
+        // Pliki zmienił inny proces (albo zakończone kompaktowanie) - wczytujemy
+        // serię od nowa, żeby nie nadpisać ani nie pominąć cudzych punktów
+        const bool compacting = it->compacting;
+        it.value() = SensorState();
+        it->compacting = compacting;
+        readSensor(sensorId, it.value());
+    }
+    return it.value();
+}
+
+QList<qint64> HistoryStore::diskStamp(int sensorId) const {
+    QList<qint64> stamp;
+    for (const char *suffix : {"dat", "log", "log.compacting", "json"}) {
+        const QFileInfo info(filePath(sensorId, suffix));
+        stamp.append(info.exists() ? info.size() : -1);
+        stamp.append(info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0);
+    }
+    return stamp;
+}
+
+void HistoryStore::readSensor(int sensorId, SensorState &state) const {
+    // Stan plików sprzed odczytu - zmiana w trakcie wymusi ponowne wczytanie
+    state.diskStamp = diskStamp(sensorId);
+
+    const QJsonObject info = QJsonDocument::fromJson(readFile(filePath(sensorId, "json"))).object();
+    state.series.info().sensorId = sensorId;
+    state.series.info().param = info["param"].toString();
+    state.series.info().paramFormula = info["paramFormula"].toString();
+    state.series.info().unit = info["unit"].toString();
+    state.lastFetched = info["lastFetched"].toVariant().toLongLong();
+
+    const QByteArray data = readFile(filePath(sensorId, "dat"));
+    if (!data.isEmpty() && !decodeData(data, state.series)) {
+        qDebug() << "Uszkodzony plik historii czujnika" << sensorId;
+        state.series.clear();
+    }
+
+    // Dzienniki czytamy po pliku .dat - przy powtórzonym znaczniku czasu
+    // sortByTime() zostawia ostatnią, czyli najnowszą wartość. Niepełny rekord
+    // na końcu dziennika (przerwany zapis) jest pomijany; appendToLog() go obetnie.
+    const QByteArray compactingLog = readFile(filePath(sensorId, "log.compacting"));
+    readRecords(compactingLog.constData(), compactingLog.size(), state.series);
+    const QByteArray log = readFile(filePath(sensorId, "log"));
+    readRecords(log.constData(), log.size(), state.series);
+    state.logRecords = int((compactingLog.size() + log.size()) / RecordSize);
+
+    state.series.sortByTime();
+}
+
+void HistoryStore::writeInfo(int sensorId, const SensorState &state) const {
+    QJsonObject info;
+    info["param"] = state.series.info().param;
+    info["paramFormula"] = state.series.info().paramFormula;
+    info["unit"] = state.series.info().unit;
+    info["lastFetched"] = state.lastFetched;
+
+    QSaveFile file(filePath(sensorId, "json"));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(info).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+bool HistoryStore::appendToLog(int sensorId, const TimeSeries &points) const {
+    QByteArray bytes;
+    bytes.reserve(points.size() * RecordSize);
+    for (int i = 0; i < points.size(); ++i) {
+        appendRecord(bytes, points.timestampAt(i), points.valueAt(i));
+    }
+
+    QFile file(filePath(sensorId, "log"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "Nie można zapisać historii czujnika" << sensorId << file.errorString();
+        return false;
+    }
+
+    // Niepełny rekord po przerwanym zapisie obcinamy - inaczej wszystkie
+    // dopisane za nim rekordy byłyby przesunięte
+    qint64 oldSize = file.size();
+    if (oldSize % RecordSize != 0) {
+        oldSize -= oldSize % RecordSize;
+        if (!file.resize(oldSize)) {
+            qDebug() << "Nie można naprawić dziennika czujnika" << sensorId << file.errorString();
+            return false;
+        }
+    }
+
+    // QFile buforuje zapis - błąd (np. brak miejsca) widać dopiero przy flush()
+    if (file.write(bytes) != bytes.size() || !file.flush()) {
+        qDebug() << "Nie można zapisać historii czujnika" << sensorId << file.errorString();
+        file.resize(oldSize);
+        return false;
+    }
+    return true;
+}
+
+TimeSeries HistoryStore::merge(const TimeSeries &fetched, int *addedCount, bool *ok) {
+    const int sensorId = fetched.info().sensorId;
+
+    // Pod blokadą stan z dysku jest aktualny i nikt inny nie dopisuje punktów
+    QLockFile lock(filePath(sensorId, "lock"));
+    if (!lock.tryLock(LockTimeoutMs)) {
+        qDebug() << "Historia czujnika" << sensorId << "jest zablokowana:" << lock.error();
+        if (addedCount) {
+            *addedCount = 0;
+        }
+        if (ok) {
+            *ok = false;
+        }
+        return state(sensorId).series;
+    }
+    SensorState &sensor = state(sensorId);
+
+    // Tylko punkty, których nie mamy lub których wartość się zmieniła
+    TimeSeries added;
+    for (int i = 0; i < fetched.size(); ++i) {
+        const qint64 timestamp = fetched.timestampAt(i);
+        const int index = sensor.series.lowerBound(timestamp);
+        if (index < sensor.series.size() && sensor.series.timestampAt(index) == timestamp
+            && sensor.series.valueAt(index) == fetched.valueAt(i)) {
+            continue;
+        }
+        added.append(timestamp, fetched.valueAt(i));
+    }
+
+    // Nieudany zapis: punkty nie są dodane, a czas pobrania się nie zmienia -
+    // następne odświeżenie spróbuje ponownie
+    const bool saved = added.isEmpty() || appendToLog(sensorId, added);
+    if (saved) {
+        for (int i = 0; i < added.size(); ++i) {
+            sensor.series.append(added.timestampAt(i), added.valueAt(i));
+        }
+        sensor.series.sortByTime();
+        sensor.logRecords += added.size();
+        sensor.lastFetched = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    sensor.series.info() = fetched.info();
+    writeInfo(sensorId, sensor);
+
+    if (sensor.logRecords >= CompactionThreshold) {
+        scheduleCompaction(sensorId);
+    }
+    // Własne zapisy nie wymagają ponownego wczytania
+    sensor.diskStamp = diskStamp(sensorId);
+
+    if (addedCount) {
+        *addedCount = saved ? added.size() : 0;
+    }
+    if (ok) {
+        *ok = saved;
+    }
+    return sensor.series;
+}
+
+void HistoryStore::scheduleCompaction(int sensorId) {
+    SensorState &sensor = m_sensors[sensorId];
+    if (sensor.compacting) {
+        return;
+    }
+
+    // Bieżący dziennik odkładamy na bok; nowe punkty trafią do świeżego pliku.
+    // Jeśli poprzednie kompaktowanie zostało przerwane, jego dziennik już czeka.
+    const QString logPath = filePath(sensorId, "log");
+    const QString compactingPath = filePath(sensorId, "log.compacting");
+    if (!QFile::exists(compactingPath) && QFile::exists(logPath) && !QFile::rename(logPath, compactingPath)) {
+        return;
+    }
+
+    sensor.compacting = true;
+    sensor.logRecords = int(QFileInfo(logPath).size() / RecordSize);
+
+    const QString dataPath = filePath(sensorId, "dat");
+    const QString lockPath = filePath(sensorId, "lock");
+
+    m_compactionPool.start([this, sensorId, dataPath, compactingPath, lockPath]() {
+        // Plik .dat budujemy z plików, a nie z serii w pamięci - odłożony dziennik
+        // mógł zawierać punkty dopisane przez inny proces
+        QLockFile lock(lockPath);
+        bool written = false;
+        if (lock.tryLock(LockTimeoutMs)) {
+            const QByteArray compactingLog = readFile(compactingPath);
+            if (compactingLog.isEmpty() && !QFile::exists(compactingPath)) {
+                // Dziennik skompaktował już inny proces
+                written = true;
+            } else {
+                TimeSeries series;
+                const QByteArray data = readFile(dataPath);
+                if (!data.isEmpty() && !decodeData(data, series)) {
+                    // Uszkodzony plik .dat (lub zapisany w nowszym formacie) zostawiamy
+                    // razem z dziennikiem - nadpisanie skasowałoby całą historię
+                    qDebug() << "Pominięto kompaktowanie nieczytelnej historii czujnika" << sensorId;
+                } else {
+                    readRecords(compactingLog.constData(), compactingLog.size(), series);
+                    series.sortByTime();
+
+                    QSaveFile file(dataPath);
+                    written = file.open(QIODevice::WriteOnly)
+                              && file.write(encodeData(series)) >= 0
+                              && file.commit();
+                    if (written) {
+                        QFile::remove(compactingPath);
+                    }
+                }
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, sensorId, written]() {
+            // Stan mógł zostać zwolniony (releaseSeries) i wczytany ponownie
+            const auto it = m_sensors.find(sensorId);
+            if (it != m_sensors.end()) {
+                it->compacting = false;
+            }
+            if (written) {
+                emit compacted(sensorId);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void HistoryStore::waitForCompaction() {
+    m_compactionPool.waitForDone();
+}
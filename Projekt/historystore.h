@@ -0,0 +1,74 @@
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QThreadPool>
+
+#include "timeseries.h"
+
+// Lokalna historia pomiarów czujników gromadzona ponad okno zwracane przez API.
+// Dla każdego czujnika w katalogu danych są trzy pliki:
+//  - <id>.dat  - skompaktowana, posortowana seria (kompresja SeriesCodec)
+//  - <id>.log  - dopisywane na końcu nowe lub zmienione punkty
+//  - <id>.json - opis serii i czas ostatniego pobrania
+// Gdy dziennik urośnie, jest kompaktowany do pliku .dat w tle.
+// Z tych samych plików może korzystać kilka procesów (okno aplikacji i demon
+// odświeżania): zapis i kompaktowanie odbywają się pod blokadą <id>.lock, a seria
+// w pamięci jest wczytywana ponownie, gdy pliki zmienił inny proces.
+// Czekanie na blokadę może potrwać kilka sekund, dlatego okno aplikacji używa
+// magazynu z osobnego wątku (obiekt należy do jednego wątku naraz).
+class HistoryStore : public QObject {
+    Q_OBJECT
+
+public:
+    // Domyślnie dane leżą w AppLocalDataLocation/history
+    explicit HistoryStore(QObject *parent = nullptr);
+    explicit HistoryStore(const QString &directory, QObject *parent = nullptr);
+    ~HistoryStore();
+
+    QString directory() const { return m_directory; }
+
+    // Zapisana historia czujnika (pusta, jeśli jeszcze jej nie ma)
+    TimeSeries load(int sensorId);
+    // Dopisuje nowe lub zmienione punkty pobranej serii i zwraca pełną historię.
+    // W addedCount zwraca liczbę dopisanych punktów (0, gdy zapis się nie powiódł),
+    // a w ok - czy zapis się powiódł (false także przy zajętej blokadzie plików).
+    TimeSeries merge(const TimeSeries &fetched, int *addedCount = nullptr, bool *ok = nullptr);
+    // Czas ostatniego scalenia danych z API (ms od epoki; 0 - nigdy)
+    qint64 lastFetched(int sensorId);
+
+    // Zwalnia serie wczytane do pamięci; przy następnym użyciu zostaną wczytane z dysku
+    void releaseSeries();
+
+    // Czeka na zakończenie kompaktowania w tle
+    void waitForCompaction();
+
+signals:
+    void compacted(int sensorId);
+
+private:
+    struct SensorState {
+        TimeSeries series;     // Pełna historia: .dat + dzienniki
+        int logRecords = 0;    // Punkty w dzienniku od ostatniego kompaktowania
+        qint64 lastFetched = 0;
+        bool compacting = false;
+        QList<qint64> diskStamp; // Rozmiary i czasy modyfikacji plików przy wczytaniu
+    };
+
+    // Stan czujnika; wczytywany z dysku przy pierwszym użyciu i po zmianie plików
+    SensorState &state(int sensorId);
+    QList<qint64> diskStamp(int sensorId) const;
+    void readSensor(int sensorId, SensorState &state) const;
+    void writeInfo(int sensorId, const SensorState &state) const;
+    bool appendToLog(int sensorId, const TimeSeries &points) const;
+    void scheduleCompaction(int sensorId);
+
+    QString filePath(int sensorId, const QString &suffix) const;
+
+    QString m_directory;
+    QHash<int, SensorState> m_sensors;
+    QThreadPool m_compactionPool;
+};
+
+#endif // HISTORYSTORE_H
@@ -0,0 +1,353 @@
+#include "jsontokenizer.h"
+#include <cstring>
+
+namespace {
+
+bool isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Cztery cyfry szesnastkowe sekwencji \uXXXX; -1 przy błędzie
+int readHex4(const char *p) {
+    int value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int digit = hexValue(p[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+void appendUtf8(QByteArray &out, uint code) {
+    if (code < 0x80) {
+        out.append(char(code));
+    } else if (code < 0x800) {
+        out.append(char(0xC0 | (code >> 6)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.append(char(0xE0 | (code >> 12)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (code >> 18)));
+        out.append(char(0x80 | ((code >> 12) & 0x3F)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+} // namespace
+
+JsonTokenizer::JsonTokenizer()
+    : m_data(nullptr),
+    m_size(0),
+    m_pos(0),
+    m_consumed(0),
+    m_finished(false),
+    m_afterKey(false),
+    m_bool(false),
+    m_failed(false),
+    m_errorOffset(-1) {
+}
+
+void JsonTokenizer::feed(QByteArrayView data) {
+    // Zużyte dane usuwamy z początku bufora - zostaje tylko niepełny token
+    if (m_data == m_buffer.constData()) {
+        m_buffer.remove(0, m_pos);
+    } else {
+        m_buffer = QByteArray(m_data + m_pos, m_size - m_pos);
+    }
+    m_consumed += m_pos;
+
+    m_buffer.append(data.data(), data.size());
+    m_data = m_buffer.constData();
+    m_size = m_buffer.size();
+    m_pos = 0;
+}
+
+void JsonTokenizer::finish() {
+    m_finished = true;
+}
+
+void JsonTokenizer::setData(QByteArrayView data) {
+    reset();
+    m_data = data.data();
+    m_size = data.size();
+    m_finished = true;
+}
+
+void JsonTokenizer::reset() {
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    m_consumed = 0;
+    m_finished = false;
+    m_stack.clear();
+    m_afterKey = false;
+    m_text = QByteArrayView();
+    m_unescaped.clear();
+    m_bool = false;
+    m_failed = false;
+    m_errorOffset = -1;
+}
+
+JsonTokenizer::Token JsonTokenizer::next() {
+    if (m_failed) {
+        return Error;
+    }
+
+    // Białe znaki i separatory
+    while (m_pos < m_size) {
+        const char c = m_data[m_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != ',' && c != ':') {
+            break;
+        }
+        ++m_pos;
+    }
+
+    if (m_pos >= m_size) {
+        if (!m_finished) {
+            return NeedMoreData;
+        }
+        return m_stack.isEmpty() ? EndOfData : fail();
+    }
+
+    switch (m_data[m_pos]) {
+    case '{':
+        ++m_pos;
+        m_stack.append('{');
+        m_afterKey = false;
+        return BeginObject;
+    case '[':
+        ++m_pos;
+        m_stack.append('[');
+        return BeginArray;
+    case '}':
+        if (!inObject()) {
+            return fail();
+        }
+        ++m_pos;
+        m_stack.chop(1);
+        m_afterKey = false;
+        return EndObject;
+    case ']':
+        if (m_stack.isEmpty() || m_stack.back() != '[') {
+            return fail();
+        }
+        ++m_pos;
+        m_stack.chop(1);
+        m_afterKey = false;
+        return EndArray;
+    case '"':
+        return readString(inObject() && !m_afterKey ? Key : String);
+    case 't':
+        return readLiteral("true", 4, Bool, true);
+    case 'f':
+        return readLiteral("false", 5, Bool, false);
+    case 'n':
+        return readLiteral("null", 4, Null, false);
+    default:
+        return readNumber();
+    }
+}
+
+JsonTokenizer::Token JsonTokenizer::readString(Token type) {
+    const char *begin = m_data + m_pos + 1;
+    const char *end = m_data + m_size;
+
+    // Zwykle tekst nie ma sekwencji ucieczki - wtedy wystarczy znaleźć cudzysłów
+    const char *quote = static_cast<const char *>(std::memchr(begin, '"', end - begin));
+    if (!quote) {
+        return m_finished ? fail() : NeedMoreData;
+    }
+    const bool escaped = std::memchr(begin, '\\', quote - begin) != nullptr;
+
+    if (escaped) {
+        // Cudzysłów poprzedzony ukośnikiem nie kończy tekstu
+        const char *p = begin;
+        while (p < end && *p != '"') {
+            p += (*p == '\\') ? 2 : 1;
+        }
+        if (p >= end) {
+            return m_finished ? fail() : NeedMoreData;
+        }
+        quote = p;
+
+        if (!unescape(begin, quote)) {
+            return fail();
+        }
+        m_text = QByteArrayView(m_unescaped.constData(), m_unescaped.size());
+    } else {
+        m_text = QByteArrayView(begin, quote - begin);
+    }
+
+    m_pos = (quote - m_data) + 1;
+    m_afterKey = (type == Key);
+    return type;
+}
+
+JsonTokenizer::Token JsonTokenizer::readNumber() {
+    qsizetype end = m_pos;
+    while (end < m_size && isNumberChar(m_data[end])) {
+        ++end;
+    }
+
+    // Liczba może być kontynuowana w następnym fragmencie
+    if (end == m_size && !m_finished) {
+        return NeedMoreData;
+    }
+    if (end == m_pos) {
+        return fail();
+    }
+
+    m_text = QByteArrayView(m_data + m_pos, end - m_pos);
+    m_pos = end;
+    m_afterKey = false;
+    return Number;
+}
+
+JsonTokenizer::Token JsonTokenizer::readLiteral(const char *literal, qsizetype length, Token type, bool value) {
+    const qsizetype available = qMin(length, m_size - m_pos);
+    if (std::memcmp(m_data + m_pos, literal, available) != 0) {
+        return fail();
+    }
+    if (available < length) {
+        return m_finished ? fail() : NeedMoreData;
+    }
+
+    m_pos += length;
+    m_bool = value;
+    m_afterKey = false;
+    return type;
+}
+
+JsonTokenizer::Token JsonTokenizer::fail() {
+    m_failed = true;
+    m_errorOffset = m_consumed + m_pos;
+    return Error;
+}
+
+bool JsonTokenizer::unescape(const char *begin, const char *end) {
+    m_unescaped.clear();
+
+    for (const char *p = begin; p < end; ++p) {
+        if (*p != '\\') {
+            m_unescaped.append(*p);
+            continue;
+        }
+
+        ++p;
+        switch (*p) {
+        case '"':
+        case '\\':
+        case '/':
+            m_unescaped.append(*p);
+            break;
+        case 'b':
+            m_unescaped.append('\b');
+            break;
+        case 'f':
+            m_unescaped.append('\f');
+            break;
+        case 'n':
+            m_unescaped.append('\n');
+            break;
+        case 'r':
+            m_unescaped.append('\r');
+            break;
+        case 't':
+            m_unescaped.append('\t');
+            break;
+        case 'u': {
+            if (end - p < 5) {
+                return false;
+            }
+            int code = readHex4(p + 1);
+            if (code < 0) {
+                return false;
+            }
+            p += 4;
+
+            // Znak spoza BMP zapisany jako para surogatów
+            if (code >= 0xD800 && code < 0xDC00 && end - p >= 7 && p[1] == '\\' && p[2] == 'u') {
+                const int low = readHex4(p + 3);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+            }
+            appendUtf8(m_unescaped, uint(code));
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+double JsonTokenizer::number(bool *ok) const {
+    // Szybka ścieżka: do 15 cyfr, bez wykładnika. Mantysa i potęga 10 są wtedy
+    // dokładnie reprezentowalne, więc iloraz jest poprawnie zaokrąglony.
+    static const double Powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+    };
+
+    const char *p = m_text.data();
+    const char *end = p + m_text.size();
+    const bool negative = p < end && *p == '-';
+    if (negative) {
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int fraction = 0;
+    bool seenDot = false;
+    bool fast = p < end;
+    for (; p < end; ++p) {
+        const char c = *p;
+        if (c >= '0' && c <= '9') {
+            if (++digits > 15) {
+                fast = false;
+                break;
+            }
+            mantissa = mantissa * 10 + quint64(c - '0');
+            if (seenDot) {
+                ++fraction;
+            }
+        } else if (c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            fast = false;
+            break;
+        }
+    }
+
+    if (fast && digits > 0) {
+        if (ok) {
+            *ok = true;
+        }
+        const double value = double(mantissa) / Powers[fraction];
+        return negative ? -value : value;
+    }
+
+    return QByteArray(m_text.data(), m_text.size()).toDouble(ok);
+}
@@ -0,0 +1,80 @@
+#ifndef JSONTOKENIZER_H
+#define JSONTOKENIZER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+// Przyrostowy tokenizer JSON (UTF-8) bez budowania drzewa dokumentu.
+// Dane można podawać fragmentami (feed) w miarę ich nadchodzenia - next() zwraca
+// NeedMoreData, gdy token nie jest jeszcze kompletny, i nie zużywa wtedy danych.
+// W buforze zostaje tylko niezużyta końcówka, więc pamięć nie rośnie z rozmiarem
+// dokumentu. Przecinki i dwukropki nie są zwracane jako tokeny.
+class JsonTokenizer {
+public:
+    enum Token {
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Key,       // Nazwa pola obiektu (text())
+        String,    // text() - tekst po rozwinięciu sekwencji ucieczki
+        Number,    // text() - zapis liczby; wartość: number()
+        Bool,      // boolean()
+        Null,
+        NeedMoreData,
+        EndOfData,
+        Error
+    };
+
+    JsonTokenizer();
+
+    // Dopisuje kolejny fragment danych. Unieważnia text() poprzedniego tokenu.
+    void feed(QByteArrayView data);
+    // Koniec danych - liczba na samym końcu jest już kompletna
+    void finish();
+    // Cały dokument naraz, bez kopiowania (dane muszą istnieć do końca odczytu)
+    void setData(QByteArrayView data);
+    void reset();
+
+    Token next();
+
+    // Tekst ostatniego tokenu Key, String lub Number (ważny do następnego next() lub feed())
+    QByteArrayView text() const { return m_text; }
+    QString string() const { return QString::fromUtf8(m_text.data(), m_text.size()); }
+    double number(bool *ok = nullptr) const;
+    bool boolean() const { return m_bool; }
+
+    // Liczba otwartych obiektów i tablic (po ostatnim tokenie)
+    int depth() const { return int(m_stack.size()); }
+    // Czy ostatni token jest wewnątrz obiektu (a nie tablicy)
+    bool inObject() const { return !m_stack.isEmpty() && m_stack.back() == '{'; }
+
+    // Przesunięcie błędu względem początku wszystkich podanych danych
+    qint64 errorOffset() const { return m_errorOffset; }
+
+private:
+    Token readString(Token type);
+    Token readNumber();
+    Token readLiteral(const char *literal, qsizetype length, Token type, bool value);
+    Token fail();
+    // Rozwija sekwencje ucieczki z [begin, end) do m_unescaped
+    bool unescape(const char *begin, const char *end);
+
+    QByteArray m_buffer;       // Niezużyta końcówka danych podawanych przez feed()
+    const char *m_data;        // Czytane dane (m_buffer albo dane z setData())
+    qsizetype m_size;
+    qsizetype m_pos;
+    qint64 m_consumed;         // Liczba bajtów usuniętych z początku bufora
+    bool m_finished;
+
+    QByteArray m_stack;        // Otwarte kontenery: '{' lub '['
+    bool m_afterKey;           // W obiekcie: nazwa pola przeczytana, czekamy na wartość
+    QByteArrayView m_text;
+    QByteArray m_unescaped;    // Tekst z rozwiniętymi sekwencjami ucieczki
+    bool m_bool;
+    bool m_failed;
+    qint64 m_errorOffset;
+};
+
+#endif // JSONTOKENIZER_H
@@ -0,0 +1,439 @@
+#include "linechartitem.h"
+#include "downsampler.h"
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGRendererInterface>
+
+// Liczba pól siatki w pionie i poziomie (jak w dawnym gridCanvas)
+static const int GridRows = 5;
+static const int GridColumns = 6;
+// Połowa boku znacznika punktu (px)
+static const float PointHalfSize = 4.0f;
+// Minimalny odstęp między punktami (px), przy którym rysujemy znaczniki
+static const double MinPointSpacing = 6.0;
+// Docelowa liczba punktów na piksel szerokości po redukcji
+static const int SamplesPerPixel = 2;
+
+// Tworzy węzeł z pustą geometrią i jednolitym kolorem
+static QSGGeometryNode *createGeometryNode(unsigned int drawingMode, float lineWidth) {
+    auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setDrawingMode(drawingMode);
+    geometry->setLineWidth(lineWidth);
+
+    auto *node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(new QSGFlatColorMaterial);
+    node->setFlag(QSGNode::OwnsMaterial);
+    return node;
+}
+
+static void setNodeColor(QSGGeometryNode *node, const QColor &color) {
+    static_cast<QSGFlatColorMaterial *>(node->material())->setColor(color);
+    node->markDirty(QSGNode::DirtyMaterial);
+}
+
+LineChartItem::LineChartItem(QQuickItem *parent)
+    : QQuickItem(parent),
+    m_rangeStart(0),
+    m_rangeEnd(0),
+    m_firstIndex(0),
+    m_lastIndex(0),
+    m_minValue(0.0),
+    m_maxValue(100.0),
+    m_lineColor("#4CAF50"),
+    m_gridColor("#eee"),
+    m_downsampling(LargestTriangle),
+    m_renderedCount(0),
+    m_labels(new ChartLabelModel(this)),
+    m_dataDirty(true),
+    m_gridDirty(true),
+    m_colorDirty(true) {
+
+    setFlag(ItemHasContents, true);
+}
+
+void LineChartItem::setHistory(SensorHistoryModel *history) {
+    if (m_history == history) {
+        return;
+    }
+
+    if (m_history) {
+        disconnect(m_history, nullptr, this, nullptr);
+    }
+
+    m_history = history;
+
+    // Każda zmiana w modelu oznacza przeliczenie widocznych punktów
+    if (m_history) {
+        connect(m_history, &QAbstractItemModel::modelReset, this, &LineChartItem::markDataDirty);
+        connect(m_history, &QAbstractItemModel::rowsInserted, this, &LineChartItem::markDataDirty);
+        connect(m_history, &QAbstractItemModel::rowsRemoved, this, &LineChartItem::markDataDirty);
+        connect(m_history, &QAbstractItemModel::dataChanged, this, &LineChartItem::markDataDirty);
+    }
+
+    emit historyChanged();
+    markDataDirty();
+}
+
+void LineChartItem::setRangeStart(qint64 rangeStart) {
+    if (m_rangeStart == rangeStart) {
+        return;
+    }
+    m_rangeStart = rangeStart;
+    emit rangeChanged();
+    markDataDirty();
+}
+
+void LineChartItem::setRangeEnd(qint64 rangeEnd) {
+    if (m_rangeEnd == rangeEnd) {
+        return;
+    }
+    m_rangeEnd = rangeEnd;
+    emit rangeChanged();
+    markDataDirty();
+}
+
+void LineChartItem::setLineColor(const QColor &color) {
+    if (m_lineColor == color) {
+        return;
+    }
+    m_lineColor = color;
+    m_colorDirty = true;
+    emit appearanceChanged();
+    update();
+}
+
+void LineChartItem::setGridColor(const QColor &color) {
+    if (m_gridColor == color) {
+        return;
+    }
+    m_gridColor = color;
+    m_colorDirty = true;
+    emit appearanceChanged();
+    update();
+}
+
+void LineChartItem::setDownsampling(Downsampling downsampling) {
+    if (m_downsampling == downsampling) {
+        return;
+    }
+    m_downsampling = downsampling;
+    emit downsamplingChanged();
+    markDataDirty();
+}
+
+void LineChartItem::markDataDirty() {
+    updateVisibleRange();
+    updateSamples();
+    updateLayout();
+}
+
+void LineChartItem::updateLayout() {
+    // Położenia punktów liczymy w wątku GUI - potrzebują ich też etykiety
+    updateLinePoints();
+    m_labels->place(m_history ? m_history->series() : TimeSeries(), m_sampleIndices, m_linePoints, size());
+    m_dataDirty = true;
+    update();
+}
+
+void LineChartItem::updateSamples() {
+    const int count = m_lastIndex - m_firstIndex;
+    const int threshold = qMax(3, int(width()) * SamplesPerPixel);
+
+    if (!m_history || count < 2) {
+        m_sampleIndices.clear();
+    } else if (m_downsampling == MinMax) {
+        Downsampler::minMax(m_history->series(), m_firstIndex, m_lastIndex, threshold, m_sampleIndices);
+    } else if (m_downsampling == LargestTriangle) {
+        Downsampler::largestTriangle(m_history->series(), m_firstIndex, m_lastIndex, threshold, m_sampleIndices);
+    } else {
+        m_sampleIndices.resize(count);
+        for (int i = 0; i < count; ++i) {
+            m_sampleIndices[i] = m_firstIndex + i;
+        }
+    }
+
+    const int renderedCount = int(m_sampleIndices.size());
+    if (m_renderedCount != renderedCount) {
+        m_renderedCount = renderedCount;
+        emit renderedCountChanged();
+    }
+}
+
+void LineChartItem::updateVisibleRange() {
+    int firstIndex = 0;
+    int lastIndex = 0;
+    double minValue = 0.0;
+    double maxValue = 100.0;
+
+    if (m_history && !m_history->series().isEmpty()) {
+        const TimeSeries &series = m_history->series();
+
+        // Zakres czasu wyznaczamy wyszukiwaniem binarnym w posortowanej serii
+        firstIndex = m_rangeStart > 0 ? series.lowerBound(m_rangeStart) : 0;
+        lastIndex = m_rangeEnd > 0 ? series.upperBound(m_rangeEnd) : series.size();
+
+        if (lastIndex > firstIndex) {
+            float minY = series.valueAt(firstIndex);
+            float maxY = minY;
+            for (int i = firstIndex + 1; i < lastIndex; ++i) {
+                minY = qMin(minY, series.valueAt(i));
+                maxY = qMax(maxY, series.valueAt(i));
+            }
+
+            // Dodajemy margines 10% do min/max
+            double yRange = maxY - minY;
+            if (yRange == 0.0) {
+                yRange = maxY != 0.0f ? maxY * 0.2 : 10.0; // Zapobiegamy dzieleniu przez zero
+            }
+            const double yMargin = yRange * 0.1;
+            minValue = qMax(0.0, minY - yMargin);
+            maxValue = maxY + yMargin;
+        } else {
+            lastIndex = firstIndex;
+        }
+    }
+
+    if (firstIndex != m_firstIndex || lastIndex != m_lastIndex
+        || minValue != m_minValue || maxValue != m_maxValue) {
+        m_firstIndex = firstIndex;
+        m_lastIndex = lastIndex;
+        m_minValue = minValue;
+        m_maxValue = maxValue;
+        emit valueRangeChanged();
+    }
+}
+
+QPointF LineChartItem::mapToPosition(qint64 timestamp, double value) const {
+    double x = 0.0;
+    if (m_history && m_lastIndex - m_firstIndex > 1) {
+        const TimeSeries &series = m_history->series();
+        const qint64 first = series.timestampAt(m_firstIndex);
+        const qint64 last = series.timestampAt(m_lastIndex - 1);
+        if (last > first) {
+            x = double(timestamp - first) / double(last - first) * width();
+        }
+    }
+
+    const double y = height() - (value - m_minValue) / (m_maxValue - m_minValue) * height();
+    return QPointF(x, y);
+}
+
+void LineChartItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) {
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+
+    if (newGeometry.size() != oldGeometry.size()) {
+        m_gridDirty = true;
+        // Liczba punktów po redukcji zależy od szerokości
+        if (newGeometry.width() != oldGeometry.width()) {
+            updateSamples();
+        }
+        updateLayout();
+    }
+}
+
+QSGNode *LineChartItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) {
+    QSGNode *node = window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software
+                        ? updateSoftwareNode(oldNode)
+                        : updateGeometryNodes(oldNode);
+
+    m_dataDirty = false;
+    m_gridDirty = false;
+    m_colorDirty = false;
+    return node;
+}
+
+void LineChartItem::updateLinePoints() {
+    const int count = int(m_sampleIndices.size());
+
+    // Linia ma sens dopiero od dwóch punktów
+    if (!m_history || count < 2) {
+        m_linePoints.clear();
+        return;
+    }
+
+    const TimeSeries &series = m_history->series();
+    const double w = width();
+    const double h = height();
+    const double firstTime = double(series.timestampAt(m_firstIndex));
+    const double timeSpan = qMax(1.0, double(series.timestampAt(m_lastIndex - 1)) - firstTime);
+    const double valueSpan = m_maxValue - m_minValue;
+
+    // resize() zachowuje pojemność bufora - bez alokacji przy tej samej liczbie punktów
+    m_linePoints.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const int index = m_sampleIndices[i];
+        m_linePoints[i] = QPointF((series.timestampAt(index) - firstTime) / timeSpan * w,
+                                  h - (series.valueAt(index) - m_minValue) / valueSpan * h);
+    }
+}
+
+bool LineChartItem::drawsPoints() const {
+    // Znaczniki punktów tylko wtedy, gdy nie zlewają się w jedną plamę
+    return !m_linePoints.isEmpty() && width() / m_linePoints.size() >= MinPointSpacing;
+}
+
+QSGNode *LineChartItem::updateGeometryNodes(QSGNode *oldNode) {
+    QSGNode *root = oldNode;
+    QSGGeometryNode *gridNode = nullptr;
+    QSGGeometryNode *lineNode = nullptr;
+    QSGGeometryNode *pointNode = nullptr;
+
+    // Węzły tworzymy raz; później zmieniamy tylko ich geometrię
+    if (!root) {
+        root = new QSGNode;
+        gridNode = createGeometryNode(QSGGeometry::DrawLines, 1.0f);
+        lineNode = createGeometryNode(QSGGeometry::DrawLineStrip, 2.0f);
+        pointNode = createGeometryNode(QSGGeometry::DrawTriangles, 1.0f);
+        root->appendChildNode(gridNode);
+        root->appendChildNode(lineNode);
+        root->appendChildNode(pointNode);
+
+        m_gridDirty = true;
+        m_dataDirty = true;
+        m_colorDirty = true;
+    } else {
+        gridNode = static_cast<QSGGeometryNode *>(root->childAtIndex(0));
+        lineNode = static_cast<QSGGeometryNode *>(root->childAtIndex(1));
+        pointNode = static_cast<QSGGeometryNode *>(root->childAtIndex(2));
+    }
+
+    if (m_colorDirty) {
+        setNodeColor(gridNode, m_gridColor);
+        setNodeColor(lineNode, m_lineColor);
+        setNodeColor(pointNode, m_lineColor);
+    }
+
+    if (m_gridDirty) {
+        updateGridGeometry(gridNode);
+    }
+
+    if (m_dataDirty) {
+        updateLineGeometry(lineNode, pointNode);
+    }
+
+    return root;
+}
+
+QSGNode *LineChartItem::updateSoftwareNode(QSGNode *oldNode) {
+    const QSize size = boundingRect().size().toSize();
+    if (size.isEmpty()) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    auto *node = static_cast<QSGImageNode *>(oldNode);
+    if (!node) {
+        node = window()->createImageNode();
+        node->setOwnsTexture(true);
+        m_gridDirty = true;
+    }
+
+    if (!m_dataDirty && !m_gridDirty && !m_colorDirty && node->texture()) {
+        return node;
+    }
+
+    if (m_softwareImage.size() != size) {
+        m_softwareImage = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    }
+    m_softwareImage.fill(Qt::transparent);
+
+    QPainter painter(&m_softwareImage);
+    painter.setPen(QPen(m_gridColor, 1));
+
+    const double w = width();
+    const double h = height();
+    for (int i = 0; i <= GridRows; ++i) {
+        const double y = h * i / GridRows;
+        painter.drawLine(QPointF(0.0, y), QPointF(w, y));
+    }
+    for (int j = 0; j <= GridColumns; ++j) {
+        const double x = w * j / GridColumns;
+        painter.drawLine(QPointF(x, 0.0), QPointF(x, h));
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(m_lineColor, 2, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    painter.drawPolyline(m_linePoints.constData(), int(m_linePoints.size()));
+
+    if (drawsPoints()) {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(m_lineColor);
+        for (const QPointF &point : std::as_const(m_linePoints)) {
+            painter.drawEllipse(point, PointHalfSize, PointHalfSize);
+        }
+    }
+    painter.end();
+
+    node->setTexture(window()->createTextureFromImage(m_softwareImage));
+    node->setRect(boundingRect());
+    return node;
+}
+
+void LineChartItem::updateGridGeometry(QSGGeometryNode *node) {
+    QSGGeometry *geometry = node->geometry();
+    geometry->allocate(2 * (GridRows + 1 + GridColumns + 1));
+    QSGGeometry::Point2D *vertices = geometry->vertexDataAsPoint2D();
+
+    const float w = float(width());
+    const float h = float(height());
+    int v = 0;
+
+    // Poziome linie siatki
+    for (int i = 0; i <= GridRows; ++i) {
+        const float y = h * i / GridRows;
+        vertices[v++].set(0.0f, y);
+        vertices[v++].set(w, y);
+    }
+
+    // Pionowe linie siatki
+    for (int j = 0; j <= GridColumns; ++j) {
+        const float x = w * j / GridColumns;
+        vertices[v++].set(x, 0.0f);
+        vertices[v++].set(x, h);
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+void LineChartItem::updateLineGeometry(QSGGeometryNode *lineNode, QSGGeometryNode *pointNode) {
+    QSGGeometry *lineGeometry = lineNode->geometry();
+    QSGGeometry *pointGeometry = pointNode->geometry();
+    const int count = int(m_linePoints.size());
+
+    // Bufor wierzchołków przydzielamy ponownie tylko przy zmianie liczby punktów
+    if (lineGeometry->vertexCount() != count) {
+        lineGeometry->allocate(count);
+    }
+    QSGGeometry::Point2D *line = lineGeometry->vertexDataAsPoint2D();
+    for (int i = 0; i < count; ++i) {
+        line[i].set(float(m_linePoints[i].x()), float(m_linePoints[i].y()));
+    }
+    lineNode->markDirty(QSGNode::DirtyGeometry);
+
+    // Każdy znacznik to kwadrat z dwóch trójkątów
+    const int pointVertexCount = drawsPoints() ? count * 6 : 0;
+    if (pointGeometry->vertexCount() != pointVertexCount) {
+        pointGeometry->allocate(pointVertexCount);
+    }
+
+    if (pointVertexCount > 0) {
+        QSGGeometry::Point2D *points = pointGeometry->vertexDataAsPoint2D();
+        for (int i = 0; i < count; ++i) {
+            const float x = line[i].x;
+            const float y = line[i].y;
+            QSGGeometry::Point2D *quad = points + i * 6;
+            quad[0].set(x - PointHalfSize, y - PointHalfSize);
+            quad[1].set(x + PointHalfSize, y - PointHalfSize);
+            quad[2].set(x - PointHalfSize, y + PointHalfSize);
+            quad[3].set(x + PointHalfSize, y - PointHalfSize);
+            quad[4].set(x + PointHalfSize, y + PointHalfSize);
+            quad[5].set(x - PointHalfSize, y + PointHalfSize);
+        }
+    }
+    pointNode->markDirty(QSGNode::DirtyGeometry);
+}
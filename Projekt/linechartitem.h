@@ -0,0 +1,134 @@
+#ifndef LINECHARTITEM_H
+#define LINECHARTITEM_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QImage>
+#include <QPointer>
+
+#include "sensorhistorymodel.h"
+#include "chartlabelmodel.h"
+
+class QSGGeometryNode;
+
+// Wykres liniowy rysowany bezpośrednio w scene graph (bez Canvas i JavaScriptu).
+// Wierzchołki są liczone z serii w SensorHistoryModel i przy zmianie danych
+// aktualizowany jest tylko bufor wierzchołków; siatka - tylko przy zmianie rozmiaru.
+// Backend programowy (QT_QUICK_BACKEND=software) nie obsługuje własnej geometrii,
+// więc tam te same wierzchołki rysujemy jednym QPainter::drawPolyline do obrazu.
+class LineChartItem : public QQuickItem {
+    Q_OBJECT
+    // Źródło danych wykresu
+    Q_PROPERTY(SensorHistoryModel *history READ history WRITE setHistory NOTIFY historyChanged)
+    // Zakres czasu (ms od epoki); 0 oznacza brak ograniczenia z danej strony
+    Q_PROPERTY(qint64 rangeStart READ rangeStart WRITE setRangeStart NOTIFY rangeChanged)
+    Q_PROPERTY(qint64 rangeEnd READ rangeEnd WRITE setRangeEnd NOTIFY rangeChanged)
+    // Zakres osi Y wyliczony z widocznych punktów (z 10% marginesem)
+    Q_PROPERTY(double minValue READ minValue NOTIFY valueRangeChanged)
+    Q_PROPERTY(double maxValue READ maxValue NOTIFY valueRangeChanged)
+    // Liczba punktów w zakresie czasu
+    Q_PROPERTY(int visibleCount READ visibleCount NOTIFY valueRangeChanged)
+    Q_PROPERTY(QColor lineColor READ lineColor WRITE setLineColor NOTIFY appearanceChanged)
+    Q_PROPERTY(QColor gridColor READ gridColor WRITE setGridColor NOTIFY appearanceChanged)
+    // Metoda redukcji punktów, gdy w zakresie jest ich więcej niż 2x szerokość w pikselach
+    Q_PROPERTY(Downsampling downsampling READ downsampling WRITE setDownsampling NOTIFY downsamplingChanged)
+    // Liczba punktów faktycznie przekazanych do rysowania
+    Q_PROPERTY(int renderedCount READ renderedCount NOTIFY renderedCountChanged)
+    // Etykiety punktów rozmieszczone bez nakładania się
+    Q_PROPERTY(ChartLabelModel *labels READ labels CONSTANT)
+
+public:
+    enum Downsampling {
+        NoDownsampling,
+        LargestTriangle,
+        MinMax
+    };
+    Q_ENUM(Downsampling)
+
+    explicit LineChartItem(QQuickItem *parent = nullptr);
+
+    SensorHistoryModel *history() const { return m_history; }
+    void setHistory(SensorHistoryModel *history);
+
+    qint64 rangeStart() const { return m_rangeStart; }
+    void setRangeStart(qint64 rangeStart);
+    qint64 rangeEnd() const { return m_rangeEnd; }
+    void setRangeEnd(qint64 rangeEnd);
+
+    double minValue() const { return m_minValue; }
+    double maxValue() const { return m_maxValue; }
+    int visibleCount() const { return m_lastIndex - m_firstIndex; }
+
+    QColor lineColor() const { return m_lineColor; }
+    void setLineColor(const QColor &color);
+    QColor gridColor() const { return m_gridColor; }
+    void setGridColor(const QColor &color);
+
+    Downsampling downsampling() const { return m_downsampling; }
+    void setDownsampling(Downsampling downsampling);
+    int renderedCount() const { return m_renderedCount; }
+    ChartLabelModel *labels() const { return m_labels; }
+
+    // Położenie punktu (czas, wartość) we współrzędnych elementu
+    Q_INVOKABLE QPointF mapToPosition(qint64 timestamp, double value) const;
+
+signals:
+    void historyChanged();
+    void rangeChanged();
+    void valueRangeChanged();
+    void appearanceChanged();
+    void downsamplingChanged();
+    void renderedCountChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    // Wyznacza widoczne punkty i zakres osi Y, oznacza dane do przerysowania
+    void updateVisibleRange();
+    void markDataDirty();
+
+    // Wybiera punkty do narysowania (po redukcji) do m_sampleIndices
+    void updateSamples();
+    // Przelicza punkty linii do m_linePoints (współrzędne elementu)
+    void updateLinePoints();
+    // Po zmianie punktów lub rozmiaru: położenia punktów, etykiety i przerysowanie
+    void updateLayout();
+    bool drawsPoints() const;
+
+    QSGNode *updateGeometryNodes(QSGNode *oldNode);
+    QSGNode *updateSoftwareNode(QSGNode *oldNode);
+    void updateGridGeometry(QSGGeometryNode *node);
+    void updateLineGeometry(QSGGeometryNode *lineNode, QSGGeometryNode *pointNode);
+
+    QPointer<SensorHistoryModel> m_history;
+    qint64 m_rangeStart;
+    qint64 m_rangeEnd;
+
+    // Widoczne punkty serii: [m_firstIndex, m_lastIndex)
+    int m_firstIndex;
+    int m_lastIndex;
+    double m_minValue;
+    double m_maxValue;
+
+    QColor m_lineColor;
+    QColor m_gridColor;
+
+    Downsampling m_downsampling;
+    int m_renderedCount;
+
+    // Indeksy punktów serii wybranych do rysowania i ich położenie na ekranie;
+    // oba bufory są używane ponownie między klatkami
+    QList<int> m_sampleIndices;
+    QList<QPointF> m_linePoints;
+    ChartLabelModel *m_labels;
+    // Obraz wykresu dla backendu programowego
+    QImage m_softwareImage;
+
+    bool m_dataDirty;
+    bool m_gridDirty;
+    bool m_colorDirty;
+};
+
+#endif // LINECHARTITEM_H
@@ -1,20 +1,39 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QtQml/qqml.h>
 #include <QDebug>
 
 #include "mainwindow.h"
+#include "linechartitem.h"
+#include "benchmark.h"
+#include "headless.h"
 
 int main(int argc, char *argv[]) {
     try {
         // Usuwamy przestarzałe ustawienie, które jest teraz domyślnie włączone
         // QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
+        // Tryb pomiarów wydajności - bez okna
+        if (argc > 1 && qstrcmp(argv[1], "--bench") == 0) {
+            QCoreApplication app(argc, argv);
+            return Benchmark::run();
+        }
+
+        // Tryb wsadowy i demon odświeżania - pobieranie pomiarów bez okna i bez silnika QML
+        if (argc > 1 && qstrcmp(argv[1], "--headless") == 0) {
+            QCoreApplication app(argc, argv);
+            return Headless::run(app.arguments());
+        }
+
         QGuiApplication app(argc, argv);
 
         // Utworzenie instancji MainWindow
         MainWindow mainWindow;
 
+        // Rejestracja wykresu rysowanego w C++ (import Stacje 1.0)
+        qmlRegisterType<LineChartItem>("Stacje", 1, 0, "LineChart");
+
         QQmlApplicationEngine engine;
 
         // Udostępnienie MainWindow w QML jako "mainWindow"
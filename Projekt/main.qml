@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
+import Stacje 1.0
 
 ApplicationWindow {
     id: root
@@ -13,55 +14,14 @@ ApplicationWindow {
     // Właściwość do przechowywania aktualnego ekranu
     property int currentScreen: 0 // 0 - lista stacji, 1 - szczegóły stacji, 2 - historia pomiarów
 
+    // Widoczny ekran jest częścią zapisywanego stanu sesji; po powrocie
+    // strzałką C++ anuluje żądania zamkniętych ekranów
+    onCurrentScreenChanged: mainWindow.showScreen(currentScreen)
+
     // Właściwości do przechowywania zakresu dat
     property date startDate: new Date()
     property date endDate: new Date()
 
-    // Nasłuchiwanie zmiany ekranu, aby zresetować wykres
-    onCurrentScreenChanged: {
-        if (currentScreen === 2) {
-            // Resetujemy wykres przy wejściu na ekran wykresu
-            resetChart();
-        }
-    }
-
-    // Funkcja do resetowania wykresu
-    function resetChart() {
-        if (dataCanvas) {
-            dataCanvas.dataPoints = [];
-            dataCanvas.minValue = 0;
-            dataCanvas.maxValue = 100;
-            dataCanvas.requestPaint();
-
-            if (gridCanvas) {
-                gridCanvas.requestPaint();
-            }
-
-            // Reset filtrowanych dat
-            chartScreen.filteredDates = [];
-            chartScreen.filteredData = [];
-
-            // Reset statystyk
-            chartScreen.lowestValue = null;
-            chartScreen.lowestDate = null;
-            chartScreen.highestValue = null;
-            chartScreen.highestDate = null;
-            chartScreen.averageValue = null;
-            chartScreen.unit = "";
-
-            // Usuwamy etykiety punktów
-            clearPointLabels();
-        }
-    }
-
-    // Funkcja do czyszczenia etykiet punktów
-    function clearPointLabels() {
-        var children = pointLabelsContainer ? pointLabelsContainer.children : [];
-        for (var i = children.length - 1; i >= 0; i--) {
-            children[i].destroy();
-        }
-    }
-
     // Nagłówek
     Rectangle {
         id: header
@@ -152,17 +112,61 @@ ApplicationWindow {
                             placeholderText: "Wprowadź nazwę miasta..."
                             font.pixelSize: 16
 
+                            // Podpowiedzi miast w trakcie pisania
+                            onTextEdited: mainWindow.citySuggestions.query = text
+
                             onAccepted: {
+                                // Ustawienie miasta uruchamia wyszukiwanie w katalogu stacji
+                                mainWindow.citySuggestions.clear();
                                 mainWindow.cityName = text;
-                                mainWindow.fetchStations(); // Dodajemy jawne wywołanie
                             }
                         }
 
                         Button {
                             text: "Szukaj"
                             onClicked: {
+                                mainWindow.citySuggestions.clear();
                                 mainWindow.cityName = cityInput.text;
-                                mainWindow.fetchStations(); // Dodajemy jawne wywołanie fetchStations()
+                            }
+                        }
+                    }
+                }
+
+                // Podpowiedzi nazw miast
+                ListView {
+                    id: citySuggestionList
+                    width: parent.width
+                    height: visible ? Math.min(count, 5) * 32 : 0
+                    visible: cityInput.activeFocus && count > 0
+                    clip: true
+                    interactive: count > 5
+
+                    model: mainWindow.citySuggestions
+
+                    delegate: Rectangle {
+                        width: citySuggestionList.width
+                        height: 32
+                        color: suggestionMouseArea.containsMouse ? "#daeaf6" : "white"
+                        border.color: "#ddd"
+
+                        Text {
+                            anchors.left: parent.left
+                            anchors.leftMargin: 10
+                            anchors.verticalCenter: parent.verticalCenter
+                            text: model.city + " <font color=\"#777\">(stacje: " + model.stationCount + ")</font>"
+                            font.pixelSize: 14
+                        }
+
+                        MouseArea {
+                            id: suggestionMouseArea
+                            anchors.fill: parent
+                            hoverEnabled: true
+                            onClicked: {
+                                // Wybór podpowiedzi od razu wyszukuje stacje
+                                var city = model.city;
+                                cityInput.text = city;
+                                mainWindow.citySuggestions.clear();
+                                mainWindow.cityName = city;
                             }
                         }
                     }
@@ -180,7 +184,7 @@ ApplicationWindow {
                 ListView {
                     id: stationList
                     width: parent.width
-                    height: parent.height - statusText.height - 70 // odejmujemy wysokość pola wyszukiwania
+                    height: parent.height - statusText.height - citySuggestionList.height - 70 // odejmujemy wysokość pola wyszukiwania i podpowiedzi
                     spacing: 10
                     clip: true
 
@@ -198,29 +202,29 @@ ApplicationWindow {
                             anchors.margins: 10
                             spacing: 5
 
-                            Text { text: "<b>Nazwa:</b> " + modelData.stationName; font.pixelSize: 14 }
-                            Text { text: "<b>ID:</b> " + modelData.stationId; font.pixelSize: 14 }
-                            Text { text: "<b>Współrzędne:</b> " + modelData.lat + ", " + modelData.lon; font.pixelSize: 14 }
-                            Text { text: "<b>Adres:</b> " + (modelData.address ? modelData.address : "Brak danych"); font.pixelSize: 14 }
+                            Text { text: "<b>Nazwa:</b> " + model.stationName; font.pixelSize: 14 }
+                            Text { text: "<b>ID:</b> " + model.stationId; font.pixelSize: 14 }
+                            Text { text: "<b>Współrzędne:</b> " + model.lat + ", " + model.lon; font.pixelSize: 14 }
+                            Text { text: "<b>Adres:</b> " + (model.address ? model.address : "Brak danych"); font.pixelSize: 14 }
                         }
 
                         MouseArea {
                             anchors.fill: parent
                             onClicked: {
                                 // Debugowanie - sprawdzamy ID stacji
-                                console.log("Wybrana stacja ID: " + modelData.stationId);
+                                console.log("Wybrana stacja ID: " + model.stationId);
 
                                 // Pobieramy dane szczegółowe dla wybranej stacji
-                                mainWindow.fetchStationDetails(modelData.stationId);
+                                mainWindow.fetchStationDetails(model.stationId);
 
                                 // Zapisujemy ID wybranej stacji
-                                mainWindow.selectedStationId = modelData.stationId;
+                                mainWindow.selectedStationId = model.stationId;
 
                                 // Zapisujemy dane wybranej stacji
-                                selectedStationInfo.stationId = modelData.stationId;
-                                selectedStationInfo.stationName = modelData.stationName;
-                                selectedStationInfo.address = modelData.address ? modelData.address : "Brak danych";
-                                selectedStationInfo.coordinates = modelData.lat + ", " + modelData.lon;
+                                selectedStationInfo.stationId = model.stationId;
+                                selectedStationInfo.stationName = model.stationName;
+                                selectedStationInfo.address = model.address ? model.address : "Brak danych";
+                                selectedStationInfo.coordinates = model.lat + ", " + model.lon;
 
                                 // Przechodzimy do ekranu szczegółów
                                 currentScreen = 1;
@@ -293,9 +297,20 @@ ApplicationWindow {
                     }
                 }
 
+                // Postęp pobierania danych czujników - wiersze pojawiają się
+                // na liście w miarę nadchodzenia odpowiedzi
+                ProgressBar {
+                    id: sensorProgressBar
+                    width: parent.width
+                    visible: mainWindow.sensorsLoading
+                    from: 0
+                    to: Math.max(1, mainWindow.sensorRequestsTotal)
+                    value: mainWindow.sensorRequestsDone
+                }
+
                 // Informacja gdy brak danych
                 Text {
-                    visible: mainWindow.sensorData.length === 0
+                    visible: mainWindow.sensorData.count === 0 && !mainWindow.sensorsLoading
                     text: "Brak dostępnych danych pomiarowych dla tej stacji"
                     font.pixelSize: 14
                     color: "#555"
@@ -310,7 +325,7 @@ ApplicationWindow {
                     height: parent.height - 250
                     spacing: 10
                     clip: true
-                    visible: mainWindow.sensorData.length > 0
+                    visible: mainWindow.sensorData.count > 0
 
                     model: mainWindow.sensorData
 
@@ -327,15 +342,15 @@ ApplicationWindow {
                             spacing: 5
 
                             Text {
-                                text: "<b>Parametr:</b> " + modelData.param + " (" + modelData.paramFormula + ")"
+                                text: "<b>Parametr:</b> " + model.param + " (" + model.paramFormula + ")"
                                 font.pixelSize: 16
                             }
                             Text {
-                                text: "<b>Ostatni pomiar:</b> " + modelData.value + " µg/m3 " + modelData.unit
+                                text: "<b>Ostatni pomiar:</b> " + model.value + " µg/m3 " + model.unit
                                 font.pixelSize: 14
                             }
                             Text {
-                                text: "<b>Data pomiaru:</b> " + modelData.date
+                                text: "<b>Data pomiaru:</b> " + model.date
                                 font.pixelSize: 14
                             }
                         }
@@ -360,11 +375,8 @@ ApplicationWindow {
                             MouseArea {
                                 anchors.fill: parent
                                 onClicked: {
-                                    // Resetowanie wykresu przed pobraniem nowych danych
-                                    resetChart();
-
                                     // Pobieramy historię pomiarów dla wybranego czujnika
-                                    mainWindow.fetchSensorHistory(modelData.id, modelData.param, modelData.paramFormula);
+                                    mainWindow.fetchSensorHistory(model.sensorId, model.param, model.paramFormula);
 
                                     // Przechodzimy do ekranu wykresu
                                     currentScreen = 2;
@@ -389,32 +401,8 @@ ApplicationWindow {
                 Text {
                     id: chartInfoText
                     width: parent.width
-                    text: {
-                        if (mainWindow.sensorHistory.length > 0 && chartScreen.filteredData && chartScreen.filteredData.length > 0) {
-                            // Znajdujemy najwcześniejszą i najpóźniejszą datę w przefiltrowanych danych
-                            var earliestDate = new Date(chartScreen.filteredData[0].date);
-                            var latestDate = new Date(chartScreen.filteredData[0].date);
-
-                            for (var i = 1; i < chartScreen.filteredData.length; i++) {
-                                var currentDate = new Date(chartScreen.filteredData[i].date);
-                                if (currentDate < earliestDate) {
-                                    earliestDate = currentDate;
-                                }
-                                if (currentDate > latestDate) {
-                                    latestDate = currentDate;
-                                }
-                            }
-
-                            // Formatujemy daty jako YYYY-MM-DD
-                            var earliestStr = earliestDate.toISOString().split('T')[0];
-                            var latestStr = latestDate.toISOString().split('T')[0];
-
-                            return "Wyświetlanie " + chartScreen.filteredData.length + " pomiarów z okresu " +
-                                  earliestStr + " - " + latestStr;
-                        } else {
-                            return "";
-                        }
-                    }
+                    // Opis zakresu jest przygotowany w modelu historii
+                    text: mainWindow.sensorHistory.rangeLabel
                     font.pixelSize: 14
                     color: "#333"
                     horizontalAlignment: Text.AlignHCenter
@@ -422,7 +410,7 @@ ApplicationWindow {
 
                 // Panel z informacjami o odczytach (statystyki)
                 Rectangle {
-                    visible: mainWindow.sensorHistory.length > 0
+                    visible: mainWindow.sensorHistory.count > 0
                     width: parent.width
                     height: 80 // Zwiększam wysokość, aby zmieścić dodatkowe informacje
                     color: "#f5f5f5"
@@ -453,8 +441,8 @@ ApplicationWindow {
                                 width: parent.width
                                 horizontalAlignment: Text.AlignHCenter
                                 text: {
-                                    if (chartScreen.highestValue !== null) {
-                                        return chartScreen.highestValue.toFixed(1) + " µg/m3 " + chartScreen.unit;
+                                    if (mainWindow.sensorHistory.rangeCount > 0) {
+                                        return mainWindow.sensorHistory.rangeMax.toFixed(1) + " µg/m3 " + mainWindow.sensorHistory.unit;
                                     }
                                     return "---";
                                 }
@@ -466,8 +454,8 @@ ApplicationWindow {
                                 width: parent.width
                                 horizontalAlignment: Text.AlignHCenter
                                 text: {
-                                    if (chartScreen.highestDate !== null) {
-                                        var date = new Date(chartScreen.highestDate);
+                                    if (mainWindow.sensorHistory.rangeCount > 0) {
+                                        var date = new Date(mainWindow.sensorHistory.rangeMaxTimestamp);
                                         return date.toLocaleDateString() + " " +
                                                date.toLocaleTimeString(Qt.locale(), "HH:mm");
                                     }
@@ -497,8 +485,8 @@ ApplicationWindow {
                                 width: parent.width
                                 horizontalAlignment: Text.AlignHCenter
                                 text: {
-                                    if (chartScreen.lowestValue !== null) {
-                                        return chartScreen.lowestValue.toFixed(1) + " µg/m3 " + chartScreen.unit;
+                                    if (mainWindow.sensorHistory.rangeCount > 0) {
+                                        return mainWindow.sensorHistory.rangeMin.toFixed(1) + " µg/m3 " + mainWindow.sensorHistory.unit;
                                     }
                                     return "---";
                                 }
@@ -510,8 +498,8 @@ ApplicationWindow {
                                 width: parent.width
                                 horizontalAlignment: Text.AlignHCenter
                                 text: {
-                                    if (chartScreen.lowestDate !== null) {
-                                        var date = new Date(chartScreen.lowestDate);
+                                    if (mainWindow.sensorHistory.rangeCount > 0) {
+                                        var date = new Date(mainWindow.sensorHistory.rangeMinTimestamp);
                                         return date.toLocaleDateString() + " " +
                                                date.toLocaleTimeString(Qt.locale(), "HH:mm");
                                     }
@@ -541,8 +529,8 @@ ApplicationWindow {
                                 width: parent.width
                                 horizontalAlignment: Text.AlignHCenter
                                 text: {
-                                    if (chartScreen.averageValue !== null) {
-                                        return chartScreen.averageValue.toFixed(1) + " µg/m3 " + chartScreen.unit;
+                                    if (mainWindow.sensorHistory.rangeCount > 0) {
+                                        return mainWindow.sensorHistory.rangeMean.toFixed(1) + " µg/m3 " + mainWindow.sensorHistory.unit;
                                     }
                                     return "---";
                                 }
@@ -599,7 +587,7 @@ ApplicationWindow {
 
                 // Informacja gdy brak danych historycznych
                 Text {
-                    visible: mainWindow.sensorHistory.length === 0
+                    visible: mainWindow.sensorHistory.count === 0
                     text: "Brak dostępnych danych historycznych dla tego czujnika"
                     font.pixelSize: 14
                     color: "#555"
@@ -610,7 +598,7 @@ ApplicationWindow {
                 // Własna implementacja wykresu
                 Rectangle {
                     id: chartContainer
-                    visible: mainWindow.sensorHistory.length > 0
+                    visible: mainWindow.sensorHistory.count > 0
                     width: parent.width
                     height: parent.height - chartInfoText.height - chartStatusText.height - statusContainer.height - 160 //zmienione ze 100
                     color: "white"
@@ -625,7 +613,7 @@ ApplicationWindow {
                         anchors.topMargin: 10
                         anchors.horizontalCenter: parent.horizontalCenter
                         text: {
-                            if (mainWindow.sensorHistory.length > 0) {
+                            if (mainWindow.sensorHistory.count > 0) {
                                 // Jeśli mamy dane, pokazujemy typ pomiaru (PM10)
                                 return mainWindow.selectedSensor.paramFormula;
                             }
@@ -642,96 +630,52 @@ ApplicationWindow {
                         anchors.fill: parent
                         anchors.margins: 50 // Zwiększony margines dla etykiet osi
 
-                        // Siatka wykresu
-                        Canvas {
-                            id: gridCanvas
+                        // Siatka i dane wykresu (element C++ rysowany w scene graph)
+                        LineChart {
+                            id: lineChart
                             anchors.fill: parent
-
-                            onPaint: {
-                                var ctx = getContext("2d");
-                                ctx.clearRect(0, 0, width, height); // Czyszczenie canvasu
-                                ctx.strokeStyle = "#eee";
-                                ctx.lineWidth = 1;
-
-                                // Poziome linie siatki
-                                var stepY = height / 5;
-                                for (var i = 0; i <= 5; i++) {
-                                    var y = i * stepY;
-                                    ctx.beginPath();
-                                    ctx.moveTo(0, y);
-                                    ctx.lineTo(width, y);
-                                    ctx.stroke();
-                                }
-
-                                // Pionowe linie siatki
-                                var stepX = width / 6;
-                                for (var j = 0; j <= 6; j++) {
-                                    var x = j * stepX;
-                                    ctx.beginPath();
-                                    ctx.moveTo(x, 0);
-                                    ctx.lineTo(x, height);
-                                    ctx.stroke();
-                                }
-                            }
+                            history: mainWindow.sensorHistory
+                            rangeStart: mainWindow.sensorHistory.rangeStart
+                            rangeEnd: mainWindow.sensorHistory.rangeEnd
                         }
 
-                        // Dane wykresu
-                        Canvas {
-                            id: dataCanvas
+                        // Kontener dla etykiet punktów
+                        Item {
+                            id: pointLabelsContainer
                             anchors.fill: parent
 
-                            property var dataPoints: []
-                            property real minValue: 0
-                            property real maxValue: 100
-
-                            onPaint: {
-                                var ctx = getContext("2d");
-                                ctx.clearRect(0, 0, width, height); // Czyszczenie canvasu
-
-                                if (dataPoints.length < 2) return;
-
-                                // Rysowanie linii
-                                ctx.strokeStyle = "#4CAF50";
-                                ctx.lineWidth = 2;
-                                ctx.lineJoin = "round";
-
-                                ctx.beginPath();
-                                for (var i = 0; i < dataPoints.length; i++) {
-                                    var point = dataPoints[i];
-                                    var x = point.x * width;
-                                    var y = height - ((point.y - minValue) / (maxValue - minValue)) * height;
-
-                                    if (i === 0) {
-                                        ctx.moveTo(x, y);
-                                    } else {
-                                        ctx.lineTo(x, y);
+                            // Etykiety rozmieszcza LineChart; delegaty są używane ponownie
+                            Repeater {
+                                model: lineChart.labels
+
+                                delegate: Column {
+                                    x: model.labelX
+                                    y: model.labelY
+                                    width: lineChart.labels.labelWidth
+                                    spacing: 1
+
+                                    Text {
+                                        text: model.valueText
+                                        font.pixelSize: 9
+                                        color: "#4CAF50"
+                                        horizontalAlignment: Text.AlignHCenter
+                                        width: parent.width
+                                    }
+                                    Text {
+                                        text: model.dateText
+                                        font.pixelSize: 8
+                                        horizontalAlignment: Text.AlignHCenter
+                                        width: parent.width
+                                    }
+                                    Text {
+                                        text: model.timeText
+                                        font.pixelSize: 8
+                                        horizontalAlignment: Text.AlignHCenter
+                                        width: parent.width
                                     }
                                 }
-                                ctx.stroke();
-
-                                // Rysowanie punktów
-                                ctx.fillStyle = "#4CAF50";
-                                for (var j = 0; j < dataPoints.length; j++) {
-                                    var dp = dataPoints[j];
-                                    var dpX = dp.x * width;
-                                    var dpY = height - ((dp.y - minValue) / (maxValue - minValue)) * height;
-
-                                    ctx.beginPath();
-                                    ctx.arc(dpX, dpY, 5, 0, 2 * Math.PI); // Zwiększony rozmiar punktu
-                                    ctx.fill();
-                                }
-
-                                // Po narysowaniu wykresu tworzymy etykiety
-                                // Qt.callLater(createDateLabels);
                             }
                         }
-
-                        // Kontener dla etykiet punktów
-                        Item {
-                            id: pointLabelsContainer
-                            anchors.fill: parent
-                            // Tu będą dynamicznie tworzone etykiety
-                        }
                     }
 
                     // Etykiety osi Y (wartości)
@@ -743,35 +687,35 @@ ApplicationWindow {
                         spacing: (chartArea.height - 60) / 4
 
                         Text {
-                            text: dataCanvas.maxValue.toFixed(1)
+                            text: lineChart.maxValue.toFixed(1)
                             font.pixelSize: 10
                             anchors.right: parent.right
                             width: 40
                             horizontalAlignment: Text.AlignRight
                         }
                         Text {
-                            text: (dataCanvas.minValue + (dataCanvas.maxValue - dataCanvas.minValue) * 0.75).toFixed(1)
+                            text: (lineChart.minValue + (lineChart.maxValue - lineChart.minValue) * 0.75).toFixed(1)
                             font.pixelSize: 10
                             anchors.right: parent.right
                             width: 40
                             horizontalAlignment: Text.AlignRight
                         }
                         Text {
-                            text: (dataCanvas.minValue + (dataCanvas.maxValue - dataCanvas.minValue) * 0.5).toFixed(1)
+                            text: (lineChart.minValue + (lineChart.maxValue - lineChart.minValue) * 0.5).toFixed(1)
                             font.pixelSize: 10
                             anchors.right: parent.right
                             width: 40
                             horizontalAlignment: Text.AlignRight
                         }
                         Text {
-                            text: (dataCanvas.minValue + (dataCanvas.maxValue - dataCanvas.minValue) * 0.25).toFixed(1)
+                            text: (lineChart.minValue + (lineChart.maxValue - lineChart.minValue) * 0.25).toFixed(1)
                             font.pixelSize: 10
                             anchors.right: parent.right
                             width: 40
                             horizontalAlignment: Text.AlignRight
                         }
                         Text {
-                            text: dataCanvas.minValue.toFixed(1)
+                            text: lineChart.minValue.toFixed(1)
                             font.pixelSize: 10
                             anchors.right: parent.right
                             width: 40
@@ -791,7 +735,7 @@ ApplicationWindow {
                 // Przycisk do zapisywania danych do pliku JSON
                 Rectangle {
                     id: saveButton
-                    visible: mainWindow.sensorHistory.length > 0
+                    visible: mainWindow.sensorHistory.count > 0
                     width: 200
                     height: 40
                     anchors.horizontalCenter: parent.horizontalCenter
@@ -837,225 +781,57 @@ ApplicationWindow {
                 }
             }
 
-            // Pomocnicze właściwości
-            property var filteredDates: []
-            property var filteredData: []
-
-            // Właściwości dla statystyk
-            property var lowestValue: null
-            property var lowestDate: null
-            property var highestValue: null
-            property var highestDate: null
-            property var averageValue: null
-            property string unit: ""
-
-            // Funkcja do tworzenia etykiet z datami pod punktami
-            function createDateLabels() {
-                // Usuwamy poprzednie etykiety
-                clearPointLabels();
-
-                // Jeśli nie mamy danych, kończymy
-                if (!filteredData || filteredData.length === 0) return;
-
-                // Ograniczamy liczbę etykiet dla czytelności
-                var maxLabels = Math.min(filteredData.length, 20);
-                var skipFactor = Math.ceil(filteredData.length / maxLabels);
-
-                for (var i = 0; i < filteredData.length; i += skipFactor) {
-                    var dataPoint = filteredData[i];
-                    var xPos = (i / (filteredData.length - 1 || 1)) * chartArea.width;
-                    var yPos = chartArea.height - ((dataPoint.value - dataCanvas.minValue) /
-                            (dataCanvas.maxValue - dataCanvas.minValue)) * chartArea.height;
-
-                    var date = new Date(dataPoint.date);
-
-                    // Format daty DD-MM
-                    var dateStr = String(date.getDate()).padStart(2, '0') + "-" +
-                                 String(date.getMonth() + 1).padStart(2, '0');
-
-                    // Format czasu HH:MM
-                    var timeStr = String(date.getHours()).padStart(2, '0') + ":" +
-                                 String(date.getMinutes()).padStart(2, '0');
-
-                    // Tworzenie elementu Column z etykietą
-                    var labelElement = Qt.createQmlObject(
-                        'import QtQuick 2.15; ' +
-                        'Column { ' +
-                        '   width: 40; ' +
-                        '   spacing: 1; ' +
-                        '   anchors.top: parent.top; ' +
-                        '   anchors.horizontalCenter: parent.left; ' +
-                        '   anchors.horizontalCenterOffset: ' + xPos + '; ' +
-                        '   anchors.topMargin: ' + (yPos + 10) + '; ' +
-                        '   Text { ' +
-                        '     text: "' + dataPoint.value.toFixed(1) + '"; ' +
-                        '     font.pixelSize: 9; ' +
-                        '     color: "#4CAF50"; ' +
-                        '     horizontalAlignment: Text.AlignHCenter; ' +
-                        '     width: parent.width; ' +
-                        '   } ' +
-                        '   Text { ' +
-                        '     text: "' + dateStr + '"; ' +
-                        '     font.pixelSize: 8; ' +
-                        '     horizontalAlignment: Text.AlignHCenter; ' +
-                        '     width: parent.width; ' +
-                        '   } ' +
-                        '   Text { ' +
-                        '     text: "' + timeStr + '"; ' +
-                        '     font.pixelSize: 8; ' +
-                        '     horizontalAlignment: Text.AlignHCenter; ' +
-                        '     width: parent.width; ' +
-                        '   } ' +
-                        '} ',
-                        pointLabelsContainer,
-                        "dynamicLabel"
-                    );
-                }
-            }
-
             // Funkcja do aktualizacji wykresu w oparciu o wybrany zakres dat
             function updateChart() {
-                if (mainWindow.sensorHistory.length === 0) return;
-
-                // Czyszczenie poprzednich danych
-                dataCanvas.dataPoints = [];
-                filteredDates = [];
-                filteredData = [];
-
-                // Usuwamy etykiety
-                clearPointLabels();
-
-                // Filtrujemy dane według zakresu dat
-                var rawFilteredData = [];
-                var minY = Number.MAX_VALUE;
-                var maxY = Number.MIN_VALUE;
-                var dates = [];
-
-                // Zmienne dla statystyk
-                var lowestValue = Number.MAX_VALUE;
-                var lowestDate = null;
-                var highestValue = Number.MIN_VALUE;
-                var highestDate = null;
-                var sum = 0;
-                var count = 0;
-                var unit = "";
-
-                for (var i = 0; i < mainWindow.sensorHistory.length; i++) {
-                    var record = mainWindow.sensorHistory[i];
-                    var recordDate = new Date(record.date);
-
-                    if (recordDate >= startDate && recordDate <= endDate) {
-                        // Zapisujemy jednostkę miary
-                        if (unit === "" && record.unit) {
-                            unit = record.unit;
-                        }
-
-                        rawFilteredData.push({
-                            date: recordDate,
-                            value: record.value
-                        });
-
-                        dates.push(record.date);
-
-                        // Aktualizujemy min/max dla osi Y
-                        minY = Math.min(minY, record.value);
-                        maxY = Math.max(maxY, record.value);
-
-                        // Aktualizujemy statystyki
-                        sum += record.value;
-                        count++;
+                if (mainWindow.sensorHistory.count === 0) return;
 
-                        // Najniższa wartość
-                        if (record.value < lowestValue) {
-                            lowestValue = record.value;
-                            lowestDate = recordDate;
-                        }
+                // Zakres wyszukuje binarnie model historii; wykres, nagłówek
+                // i panel statystyk wiążą się z jego właściwościami
+                mainWindow.sensorHistory.setRange(startDate.getTime(), endDate.getTime());
+            }
 
-                        // Najwyższa wartość
-                        if (record.value > highestValue) {
-                            highestValue = record.value;
-                            highestDate = recordDate;
-                        }
-                    }
-                }
+            // Ustawia zakres wykresu na ostatni tydzień historii
+            function showLastWeek() {
+                if (mainWindow.sensorHistory.count > 0) {
+                    // Ustawiamy domyślne daty - ostatni tydzień
+                    var lastDate = new Date(mainWindow.sensorHistory.lastTimestamp);
+                    var weekBefore = new Date(lastDate);
+                    weekBefore.setDate(lastDate.getDate() - 7);
 
-                // Sortujemy dane po dacie (od najstarszych do najnowszych)
-                rawFilteredData.sort(function(a, b) {
-                    return a.date - b.date;
-                });
-
-                // Zapisujemy przefiltrowane daty i dane
-                filteredData = rawFilteredData;
-                filteredDates = dates.sort(function(a, b) {
-                    return new Date(a) - new Date(b);
-                });
-
-                // Dodajemy margines 10% do min/max
-                var yRange = maxY - minY;
-                if (yRange === 0) yRange = maxY * 0.2 || 10; // Zapobiegamy dzieleniu przez zero
-
-                var yMargin = yRange * 0.1;
-                minY = Math.max(0, minY - yMargin);
-                maxY = maxY + yMargin;
-
-                // Aktualizujemy dane dla canvas
-                var dataPoints = [];
-                for (var j = 0; j < filteredData.length; j++) {
-                    var position = j / (filteredData.length - 1 || 1);
-                    dataPoints.push({
-                        x: position,
-                        y: filteredData[j].value
-                    });
-                }
+                    startDate = weekBefore;
+                    endDate = lastDate;
 
-                dataCanvas.dataPoints = dataPoints;
-                dataCanvas.minValue = minY;
-                dataCanvas.maxValue = maxY;
-                dataCanvas.requestPaint();
-                gridCanvas.requestPaint();
-
-                // Aktualizacja statystyk
-                if (count > 0) {
-                    chartScreen.lowestValue = lowestValue;
-                    chartScreen.lowestDate = lowestDate;
-                    chartScreen.highestValue = highestValue;
-                    chartScreen.highestDate = highestDate;
-                    chartScreen.averageValue = sum / count;
-                    chartScreen.unit = unit;
-                } else {
-                    chartScreen.lowestValue = null;
-                    chartScreen.lowestDate = null;
-                    chartScreen.highestValue = null;
-                    chartScreen.highestDate = null;
-                    chartScreen.averageValue = null;
-                    chartScreen.unit = "";
+                    // Aktualizujemy wykres z nowymi danymi
+                    updateChart();
                 }
             }
 
             // Inicjalizacja wykresu po załadowaniu ekranu
             Component.onCompleted: {
                 // Łączymy zmianę w mainWindow.sensorHistory z aktualizacją wykresu
-                mainWindow.sensorHistoryChanged.connect(function() {
-                    if (mainWindow.sensorHistory.length > 0) {
-                        // Ustawiamy domyślne daty - ostatni tydzień
-                        var lastDate = new Date(mainWindow.sensorHistory[0].date);
-                        var weekBefore = new Date(lastDate);
-                        weekBefore.setDate(lastDate.getDate() - 7);
-
-                        startDate = weekBefore;
-                        endDate = lastDate;
-
-                        // Aktualizujemy wykres z nowymi danymi
-                        updateChart();
-                    }
-                });
+                mainWindow.sensorHistoryChanged.connect(showLastWeek);
             }
 
         }
     }
 
-    // Po załadowaniu okna wywołujemy pobieranie danych
+    // Po załadowaniu okna odtwarzamy ostatni widok z danych lokalnych;
+    // katalog stacji, pomiary i historia są odświeżane w tle
     Component.onCompleted: {
-        mainWindow.fetchStations();
+        var view = mainWindow.restoreSession();
+        cityInput.text = mainWindow.cityName;
+
+        if (view.screen > 0) {
+            selectedStationInfo.stationId = view.stationId;
+            selectedStationInfo.stationName = view.stationName;
+            selectedStationInfo.address = view.address;
+            selectedStationInfo.coordinates = view.coordinates;
+        }
+        currentScreen = view.screen;
+
+        // Historia mogła zostać wczytana, zanim wykres podłączył się do sygnału
+        if (currentScreen === 2) {
+            chartScreen.showLastWeek();
+        }
     }
 }
@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "giosdate.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -9,10 +10,27 @@
 #include <QDir>
 #include <QTimer>
 
+// Czas, po którym przestajemy czekać na odpowiedzi czujników stacji
+static const int SensorBatchTimeoutMs = 15000;
+// Pomiary są godzinowe - historii pobranej niedawno nie pobieramy ponownie
+static const qint64 HistoryRefreshMs = 15 * 60 * 1000;
+
 MainWindow::MainWindow(QObject *parent)
     : QObject(parent),
-    m_networkManager(new QNetworkAccessManager(this)),
-    m_currentRequestType(StationList) {
+    m_client(new GiosClient(this)),
+    m_detailsStationId(0),
+    m_sensorRequestsTotal(0),
+    m_sensorRequestsDone(0),
+    m_sensorBatchActive(false),
+    m_sensorBatchTimer(new QTimer(this)),
+    m_airQualityStationId(0),
+    m_catalogRequestPending(false),
+    m_citySuggestions(new CitySuggestionModel(&m_citySearchIndex, this)),
+    m_stationModel(new StationListModel(this)),
+    m_sensorDataModel(new SensorDataModel(this)),
+    m_sensorHistoryModel(new SensorHistoryModel(this)),
+    m_historyThread(new QThread(this)),
+    m_historyStore(new HistoryStore) {
 
     // Domyślna wartość dla nazwy miasta - pusta
     m_cityName = "";
@@ -24,64 +42,103 @@ MainWindow::MainWindow(QObject *parent)
     // Inicjalizacja ID wybranej stacji
     m_selectedStationId = 0;
 
-    // Połączenie sygnału finished z QNetworkAccessManager do slota onNetworkReply
-    connect(m_networkManager, &QNetworkAccessManager::finished, this, &MainWindow::onNetworkReply);
+    // Limit czasu na odpowiedzi wszystkich czujników stacji
+    m_sensorBatchTimer->setSingleShot(true);
+    m_sensorBatchTimer->setInterval(SensorBatchTimeoutMs);
+    connect(m_sensorBatchTimer, &QTimer::timeout, this, [this]() {
+        finishSensorBatch(true);
+    });
+
+    // Historia na dysku jest wspólna z trybem --daemon: odczyt, scalanie i czekanie
+    // na blokadę pliku odbywają się w osobnym wątku, żeby nie blokować interfejsu
+    m_historyStore->moveToThread(m_historyThread);
+    connect(m_historyThread, &QThread::finished, m_historyStore, &QObject::deleteLater);
+    m_historyThread->start();
+
+    // Odpowiedzi API (już sparsowane) trafiają do obsługi według rodzaju zapytania
+    connect(m_client, &GiosClient::stationListReceived, this, &MainWindow::handleStationListReply);
+    connect(m_client, &GiosClient::stationSensorsReceived, this, &MainWindow::handleStationDetailsReply);
+    connect(m_client, &GiosClient::sensorDataReceived, this, &MainWindow::handleSensorDataReply);
+    connect(m_client, &GiosClient::sensorHistoryReceived, this,
+            [this](int sensorId, int, const ParsedReply &reply) {
+                handleSensorHistoryReply(sensorId, reply);
+            });
+    connect(m_client, &GiosClient::airQualityReceived, this, &MainWindow::handleAirQualityResponse);
+
+    // Ostatni pobrany katalog stacji jest dostępny od razu, także bez sieci;
+    // fetchStations() odświeży go w tle, gdy będzie nieaktualny
+    m_catalog.setSnapshotPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                              + "/catalog.bin");
+    if (m_catalog.loadSnapshot()) {
+        m_citySearchIndex.build(m_catalog.stations());
+        m_citySuggestions->refresh();
+    }
 }
 
 MainWindow::~MainWindow() {
-    delete m_networkManager;
+    delete m_client;
+    m_historyThread->quit();
+    m_historyThread->wait();
+}
+
+void MainWindow::cancelStationRequests() {
+    m_client->cancelRequests("station");
+
+    // Bez tego limit czasu zakończyłby pobieranie i nadpisał status innego ekranu
+    if (m_sensorBatchActive) {
+        m_sensorBatchActive = false;
+        m_sensorBatchTimer->stop();
+        emit sensorProgressChanged();
+    }
 }
 
-void MainWindow::handleAirQualityResponse(QNetworkReply *reply) {
-    if (reply->error() != QNetworkReply::NoError) {
+void MainWindow::handleAirQualityResponse(int stationId, const ParsedReply &reply) {
+    // Odpowiedź dla innej stacji niż aktualnie wybrana jest już nieaktualna
+    if (stationId != m_selectedStationId) {
+        return;
+    }
+
+    if (reply.error != QNetworkReply::NoError) {
+        // Bez sieci zostawiamy ostatni znany indeks tej stacji
+        if (!m_airQualityStatus.isEmpty()) {
+            qDebug() << "Nie udało się odświeżyć jakości powietrza:" << reply.errorString;
+            return;
+        }
         m_airQualityStatus = "Nie można pobrać informacji o jakości powietrza";
         emit airQualityStatusChanged();
         return;
     }
 
-    // Parsowanie odpowiedzi JSON
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject dataObject = doc.object();
-
     // Sprawdzamy, czy otrzymaliśmy poprawne dane
-    if (dataObject.isEmpty()) {
+    if (!reply.hasAirQualityData) {
         m_airQualityStatus = "Brak danych o jakości powietrza";
         emit airQualityStatusChanged();
         return;
     }
 
-    // Pobieramy ogólny indeks jakości powietrza
-    QJsonValue stIndexLevel = dataObject["stIndexLevel"];
-    QString indexLevel;
-
-    if (!stIndexLevel.isNull() && stIndexLevel.isObject()) {
-        QJsonObject indexObj = stIndexLevel.toObject();
-        indexLevel = indexObj["indexLevelName"].toString();
-    } else {
-        // Alternatywnie, możemy spróbować pobrać indeks PM10 jako przykład
-        QJsonValue pm10IndexLevel = dataObject["pm10IndexLevel"];
-        if (!pm10IndexLevel.isNull() && pm10IndexLevel.isObject()) {
-            QJsonObject indexObj = pm10IndexLevel.toObject();
-            indexLevel = indexObj["indexLevelName"].toString();
-        }
-    }
-
-    if (!indexLevel.isEmpty()) {
-        m_airQualityStatus = "Jakość powietrza: " + indexLevel;
+    if (!reply.airQualityLevel.isEmpty()) {
+        m_airQualityStatus = "Jakość powietrza: " + reply.airQualityLevel;
     } else {
         m_airQualityStatus = "Brak informacji o jakości powietrza";
     }
 
     emit airQualityStatusChanged();
+
+    m_session.airQualityStatus = m_airQualityStatus;
+    saveSession();
 }
 
 void MainWindow::fetchAirQualityStatus(int stationId) {
     // Debugowanie - sprawdzamy ID stacji
     qDebug() << "Pobieranie jakości powietrza dla stacji ID: " << stationId;
 
-    // Resetujemy poprzedni status jakości powietrza
-    m_airQualityStatus = "";
-    emit airQualityStatusChanged();
+    // Status innej stacji resetujemy; status tej samej stacji (np. odtworzony
+    // z sesji) zostaje widoczny do czasu nadejścia odpowiedzi
+    if (m_airQualityStationId != stationId) {
+        m_airQualityStationId = stationId;
+        m_airQualityStatus = "";
+        emit airQualityStatusChanged();
+    }
 
     // Jeśli ID stacji jest nieprawidłowe, kończymy
     if (stationId <= 0) {
@@ -91,15 +148,7 @@ void MainWindow::fetchAirQualityStatus(int stationId) {
     }
 
     // Wysłanie żądania GET do API GIOŚ dla indeksu jakości powietrza
-    QUrl url(QString("https://api.gios.gov.pl/pjp-api/rest/aqindex/getIndex/%1").arg(stationId));
-    QNetworkRequest request(url);
-
-    // m_status = "Pobieranie indeksu jakości powietrza...";
-    m_status = "Indeksu jakości powietrza pobrany";
-    emit statusChanged();
-
-    m_currentRequestType = AirQualityIndex;
-    m_networkManager->get(request);
+    m_client->fetchAirQualityIndex(stationId);
 }
 
 void MainWindow::setCityName(const QString &cityName) {
@@ -107,34 +156,126 @@ void MainWindow::setCityName(const QString &cityName) {
     m_cityName = cityName;
     emit cityNameChanged();
 
-    // Po zmianie miasta, zawsze pobieramy stacje, nawet jeśli nazwa nie zmieniła się
+    // Dane stacji wybranej w poprzednim wyszukiwaniu nie są już potrzebne
+    cancelStationRequests();
+    m_client->cancelRequests("history");
+    m_client->cancelRequests("airQuality");
+
+    m_session.cityName = cityName;
+    saveSession();
+
+    // Po zmianie miasta, zawsze wyszukujemy stacje, nawet jeśli nazwa nie zmieniła się
     fetchStations();
 }
 
 void MainWindow::fetchStations() {
-    // Wysłanie żądania GET do API GIOŚ
-    QUrl url("https://api.gios.gov.pl/pjp-api/rest/station/findAll");
-    QNetworkRequest request(url);
-
     qDebug() << "Wyszukiwanie stacji dla miasta: " << m_cityName;
 
-    m_status = "Ładowanie danych stacji...";
-    emit statusChanged();
+    // Mamy katalog - wyszukujemy od razu, a nieaktualny odświeżamy w tle
+    if (!m_catalog.isEmpty()) {
+        showStationsForCity();
+        if (!m_catalog.isFresh()) {
+            requestStationCatalog();
+        }
+        return;
+    }
 
-    m_currentRequestType = StationList;
-    m_networkManager->get(request);
+    if (!m_cityName.isEmpty()) {
+        m_status = "Ładowanie danych stacji...";
+        emit statusChanged();
+    }
+
+    requestStationCatalog();
+}
+
+void MainWindow::requestStationCatalog() {
+    // Katalog pobieramy tylko raz, nawet przy wielu wyszukiwaniach w trakcie
+    if (m_catalogRequestPending) {
+        return;
+    }
+    m_catalogRequestPending = true;
+
+    // Użytkownik czeka na katalog tylko wtedy, gdy nie mamy żadnej jego kopii
+    const RequestScheduler::Priority priority = (m_cityName.isEmpty() || !m_catalog.isEmpty())
+                                                    ? RequestScheduler::Background
+                                                    : RequestScheduler::Interactive;
+    m_client->fetchStationList(priority);
+}
+
+void MainWindow::showStationsForCity() {
+    // Przy pustej nazwie miasta zostawiamy ekran bez zmian
+    if (m_cityName.trimmed().isEmpty()) {
+        return;
+    }
+
+    // Nazwa bez dokładnego trafienia ("krak", "Krakuw") - miasto podstawiamy tylko
+    // przy jednoznacznym dopasowaniu; w pozostałych przypadkach wybór należy do
+    // listy podpowiedzi
+    QString cityName = m_cityName;
+    QList<StationRecord> stations = m_catalog.stationsInCity(cityName);
+    bool substituted = false;
+    if (stations.isEmpty()) {
+        CityMatch match;
+        if (m_citySearchIndex.resolveUnambiguous(m_cityName, &match)) {
+            cityName = match.city;
+            stations = m_catalog.stationsInCity(cityName);
+            substituted = true;
+        }
+    }
+
+    // Model nanosi tylko różnice względem poprzedniej listy
+    m_stationModel->setStations(stations);
+
+    // Aktualizacja statusu
+    if (stations.isEmpty()) {
+        m_status = "Nie znaleziono stacji w mieście: " + m_cityName;
+    } else if (substituted) {
+        m_status = QString("Nie znaleziono miasta \"%1\" - pokazano stacje w mieście: %2")
+                       .arg(m_cityName.trimmed(), cityName);
+    } else {
+        m_status = "Znaleziono stacje w mieście: " + cityName;
+    }
+
+    emit statusChanged();
 }
 
 void MainWindow::fetchStationDetails(int stationId) {
-    // Wysłanie żądania GET do API GIOŚ dla szczegółów stacji
-    QUrl url(QString("https://api.gios.gov.pl/pjp-api/rest/station/sensors/%1").arg(stationId));
-    QNetworkRequest request(url);
+    // Dane poprzedniej stacji nie są już potrzebne
+    m_client->cancelRequests("station");
+    m_client->cancelRequests("history");
+    m_client->cancelRequests("airQuality");
+
+    // Zapamiętujemy stację - odpowiedzi dla innych stacji zostaną pominięte
+    m_detailsStationId = stationId;
+    m_sensorMeta.clear();
+    m_sensorsUpdated.clear();
+    m_sensorBatchActive = false;
+    m_sensorBatchTimer->stop();
+    m_sensorRequestsTotal = 0;
+    m_sensorRequestsDone = 0;
+    emit sensorProgressChanged();
 
     m_status = "Ładowanie szczegółów stacji...";
     emit statusChanged();
 
-    m_currentRequestType = StationDetails;
-    m_networkManager->get(request);
+    // Nowa stacja w sesji - dane poprzedniej nie są już aktualne
+    if (m_session.station.id != stationId) {
+        m_session.station = StationRecord();
+        m_session.station.id = stationId;
+        for (const StationRecord &station : m_stationModel->stations()) {
+            if (station.id == stationId) {
+                m_session.station = station;
+                break;
+            }
+        }
+        m_session.readings.clear();
+        m_session.airQualityStatus.clear();
+        m_session.sensorId = 0;
+        saveSession();
+    }
+
+    // Wysłanie żądania GET do API GIOŚ dla szczegółów stacji
+    m_client->fetchStationSensors(stationId);
 }
 
 void MainWindow::fetchSensorData(int stationId) {
@@ -150,147 +291,145 @@ void MainWindow::fetchSensorHistory(int sensorId, const QString &paramName, cons
     m_selectedSensor["paramFormula"] = paramFormula;
     emit selectedSensorChanged();
 
-    // Czyszczenie historii
-    m_sensorHistory.clear();
-    emit sensorHistoryChanged();
+    m_session.sensorId = sensorId;
+    m_session.param = paramName;
+    m_session.paramFormula = paramFormula;
+    saveSession();
 
-    // Wysłanie żądania GET do API GIOŚ dla historii danych z czujnika
-    QUrl url(QString("https://api.gios.gov.pl/pjp-api/rest/data/getData/%1").arg(sensorId));
-    QNetworkRequest request(url);
+    // Historia poprzednio wybranego czujnika nie jest już potrzebna
+    m_client->cancelRequests("history");
 
+    // Pobierz także jakość powietrza dla stacji jeśli mamy ID stacji -
+    // może być w toku jednocześnie z historią
+    if (m_selectedStationId > 0) {
+        fetchAirQualityStatus(m_selectedStationId);
+    }
+
+    // Poprzedni wykres znika od razu; historia z dysku pojawi się po odczycie
+    m_sensorHistoryModel->clear();
+    emit sensorHistoryChanged();
     m_status = QString("Ładowanie historii pomiarów dla: %1 (%2)...").arg(paramName).arg(paramFormula);
     emit statusChanged();
 
-    m_currentRequestType = SensorHistory;
-    m_networkManager->get(request);
+    // Historia zapisana lokalnie jest dostępna także dla dłuższych okresów niż
+    // zwraca API; odpowiedź z API jedynie ją uzupełni
+    HistoryStore *store = m_historyStore;
+    QMetaObject::invokeMethod(store, [this, store, sensorId]() {
+        const TimeSeries stored = store->load(sensorId);
+        const qint64 lastFetched = store->lastFetched(sensorId);
+        QMetaObject::invokeMethod(this, [this, sensorId, stored, lastFetched]() {
+            showStoredHistory(sensorId, stored, lastFetched);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
 
-    // Pobierz także jakość powietrza dla stacji jeśli mamy ID stacji
-    if (m_selectedStationId > 0) {
-        // Uruchamiamy po krótkim opóźnieniu, aby nie pomieszać żądań
-        QTimer::singleShot(100, this, [this]() {
-            fetchAirQualityStatus(m_selectedStationId);
-        });
+void MainWindow::showStoredHistory(int sensorId, TimeSeries stored, qint64 lastFetched) {
+    // W międzyczasie wybrano inny czujnik
+    if (sensorId != m_selectedSensor["id"].toInt()) {
+        return;
     }
-}
 
-void MainWindow::onNetworkReply(QNetworkReply *reply) {
-    // Obsługujemy różne typy zapytań
-    switch (m_currentRequestType) {
-    case StationList:
-        handleStationListReply(reply);
-        break;
-    case StationDetails:
-        handleStationDetailsReply(reply);
-        break;
-    case SensorData:
-        handleSensorDataReply(reply);
-        break;
-    case SensorHistory:
-        handleSensorHistoryReply(reply);
-        break;
-    case AirQualityIndex: // Dodaj ten case
-        handleAirQualityResponse(reply);
-        break;
-    }
-
-    reply->deleteLater();
-}
+    if (!stored.isEmpty()) {
+        stored.info().param = m_selectedSensor["param"].toString();
+        stored.info().paramFormula = m_selectedSensor["paramFormula"].toString();
+        m_sensorHistoryModel->setSeries(stored);
+        emit sensorHistoryChanged();
+    }
 
-void MainWindow::handleStationListReply(QNetworkReply *reply) {
-    if (reply->error() != QNetworkReply::NoError) {
-        m_status = "Błąd podczas pobierania danych: " + reply->errorString();
+    // Dane pobrane przed chwilą - nowych pomiarów jeszcze nie będzie
+    const qint64 sinceFetch = QDateTime::currentMSecsSinceEpoch() - lastFetched;
+    if (!stored.isEmpty() && sinceFetch < HistoryRefreshMs) {
+        m_status = QString("Załadowano %1 pomiarów historycznych (z pamięci lokalnej)").arg(stored.size());
         emit statusChanged();
         return;
     }
 
-    // Parsowanie odpowiedzi JSON
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonArray stationsArray = doc.array();
-
-    // Czyszczenie poprzednich danych
-    m_stations.clear();
-    bool found = false;
-
-    // Przeszukiwanie stacji w poszukiwaniu podanego miasta
-    for (const QJsonValue &value : stationsArray) {
-        QJsonObject station = value.toObject();
-        QJsonObject city = station["city"].toObject();
-        QString cityName = city["name"].toString();
-
-        if (cityName.toLower() == m_cityName.toLower()) {
-            found = true;
-            QVariantMap stationData;
-            stationData["stationId"] = station["id"].toInt();
-            stationData["stationName"] = station["stationName"].toString();
-            stationData["lat"] = station["gegrLat"].toString();
-            stationData["lon"] = station["gegrLon"].toString();
-            stationData["address"] = station["addressStreet"].toString();
-            m_stations.append(stationData);
+    // Wysłanie żądania GET do API GIOŚ dla historii danych z czujnika
+    m_client->fetchSensorHistory(sensorId, m_selectedStationId);
+}
+
+void MainWindow::handleStationListReply(const ParsedReply &reply) {
+    m_catalogRequestPending = false;
+
+    if (reply.error != QNetworkReply::NoError) {
+        // Nieudane odświeżenie w tle - zostajemy przy poprzednim katalogu
+        if (!m_catalog.isEmpty()) {
+            qDebug() << "Nie udało się odświeżyć katalogu stacji:" << reply.errorString;
+            return;
         }
+        m_status = "Błąd podczas pobierania danych: " + reply.errorString;
+        emit statusChanged();
+        return;
     }
 
-    // Aktualizacja statusu
-    if (!found) {
-        m_status = "Nie znaleziono stacji w mieście: " + m_cityName;
-    } else {
-        m_status = "Znaleziono stacje w mieście: " + m_cityName;
-    }
+    // Migawka katalogu i indeks miast są już zbudowane w wątku parsera
+    m_catalog.setSnapshot(reply.catalogSnapshot);
+    m_citySearchIndex = reply.cityIndex;
+    m_citySuggestions->refresh();
 
-    emit stationsChanged();
-    emit statusChanged();
+    // Wyszukiwanie w nowym katalogu
+    showStationsForCity();
 }
 
-void MainWindow::handleStationDetailsReply(QNetworkReply *reply) {
-    if (reply->error() != QNetworkReply::NoError) {
-        m_status = "Błąd podczas pobierania szczegółów stacji: " + reply->errorString();
-        emit statusChanged();
+void MainWindow::handleStationDetailsReply(int stationId, const ParsedReply &reply) {
+    // Odpowiedź dla poprzednio wybranej stacji - pomijamy
+    if (stationId != m_detailsStationId) {
         return;
     }
 
-    // Parsowanie odpowiedzi JSON
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonArray sensorsArray = doc.array();
+    if (reply.error != QNetworkReply::NoError) {
+        m_status = "Błąd podczas pobierania szczegółów stacji: " + reply.errorString;
+        emit statusChanged();
+        return;
+    }
 
-    // Czyszczenie poprzednich danych
-    m_sensorData.clear();
-    m_pendingSensorRequests = sensorsArray.size();
+    m_sensorMeta.clear();
 
-    if (m_pendingSensorRequests == 0) {
+    if (reply.sensors.isEmpty()) {
+        m_sensorDataModel->clear();
         m_status = "Brak dostępnych czujników dla tej stacji";
         emit statusChanged();
         return;
     }
 
-    // Przetwarzanie danych czujników
-    for (const QJsonValue &value : sensorsArray) {
-        QJsonObject sensor = value.toObject();
-        int sensorId = sensor["id"].toInt();
-
-        // Tworzymy tymczasowy obiekt z podstawowymi danymi czujnika
-        QVariantMap sensorData;
-        sensorData["id"] = sensorId;
-        sensorData["param"] = sensor["param"].toObject()["paramName"].toString();
-        sensorData["paramCode"] = sensor["param"].toObject()["paramCode"].toString();
-        sensorData["paramFormula"] = sensor["param"].toObject()["paramFormula"].toString();
-
-        // Zapisujemy dane w tymczasowej mapie, by później połączyć je z wartościami
-        m_tempSensorMap.insert(sensorId, sensorData);
+    // Zapisujemy dane czujników, by połączyć je z wartościami z odpowiedzi
+    for (const SensorReading &sensor : reply.sensors) {
+        m_sensorMeta.insert(sensor.sensorId, sensor);
+    }
 
-        // Pobieramy dane pomiarowe dla każdego czujnika
-        fetchSensorDataForParam(sensorId);
+    // Pomiary czujników, które nadal są na stacji (np. odtworzone z sesji),
+    // zostają w modelu do czasu nadejścia nowych wartości; pozostałe usuwamy
+    QList<SensorReading> kept;
+    for (const SensorReading &reading : m_sensorDataModel->readings()) {
+        const auto sensorIt = m_sensorMeta.constFind(reading.sensorId);
+        if (sensorIt != m_sensorMeta.constEnd()) {
+            SensorReading updated = reading;
+            updated.position = sensorIt->position;
+            kept.append(updated);
+        }
+    }
+    m_sensorDataModel->setReadings(kept);
+
+    // Rozpoczynamy pobieranie - każdy czujnik trafi do modelu, gdy tylko
+    // nadejdzie jego odpowiedź
+    m_sensorRequestsTotal = reply.sensors.size();
+    m_sensorRequestsDone = 0;
+    m_sensorBatchActive = true;
+    m_sensorBatchTimer->start();
+    emit sensorProgressChanged();
+
+    // Pobieramy dane pomiarowe dla każdego czujnika
+    for (const SensorReading &sensor : reply.sensors) {
+        fetchSensorDataForParam(sensor.sensorId, stationId);
     }
 
     m_status = "Ładowanie danych pomiarowych...";
     emit statusChanged();
 }
 
-void MainWindow::fetchSensorDataForParam(int sensorId) {
+void MainWindow::fetchSensorDataForParam(int sensorId, int stationId) {
     // Wysłanie żądania GET do API GIOŚ dla danych z czujnika
-    QUrl url(QString("https://api.gios.gov.pl/pjp-api/rest/data/getData/%1").arg(sensorId));
-    QNetworkRequest request(url);
-
-    m_currentRequestType = SensorData;
-    m_networkManager->get(request);
+    m_client->fetchSensorData(sensorId, stationId);
 }
 
 void MainWindow::fetchAirQualityForStation(int stationId) {
@@ -304,166 +443,154 @@ void MainWindow::fetchAirQualityForStation(int stationId) {
     }
 }
 
-void MainWindow::handleSensorDataReply(QNetworkReply *reply) {
-    // Zmniejszamy licznik oczekujących zapytań
-    m_pendingSensorRequests--;
-
-    if (reply->error() != QNetworkReply::NoError) {
-        // Nawet w przypadku błędu sprawdzamy, czy to było ostatnie żądanie
-        if (m_pendingSensorRequests == 0) {
-            finalizeAndFilterSensorData();
-        }
+void MainWindow::handleSensorDataReply(int sensorId, int stationId, const ParsedReply &reply) {
+    // Odpowiedź należy do innej stacji niż ta, której szczegóły pobieramy
+    if (stationId != m_detailsStationId) {
         return;
     }
 
-    // Parsowanie odpowiedzi JSON
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject dataObject = doc.object();
-
-    // Sprawdzamy czy mamy jakieś wartości
-    QJsonArray values = dataObject["values"].toArray();
-    if (values.isEmpty()) {
-        // Jeśli to ostatnie żądanie, finalizujemy dane
-        if (m_pendingSensorRequests == 0) {
-            finalizeAndFilterSensorData();
+    const auto sensorIt = m_sensorMeta.constFind(sensorId);
+
+    if (reply.error == QNetworkReply::NoError && sensorIt != m_sensorMeta.constEnd()) {
+        const TimeSeries &values = reply.values;
+
+        // Odpowiedź zawiera całą historię czujnika - zapisujemy ją, dzięki czemu
+        // otwarcie wykresu tego czujnika nie pobiera jej ponownie
+        TimeSeries history = values;
+        history.info().sensorId = sensorId;
+        history.info().param = sensorIt->param;
+        history.info().paramFormula = sensorIt->paramFormula;
+        HistoryStore *store = m_historyStore;
+        QMetaObject::invokeMethod(store, [store, history]() {
+            store->merge(history);
+        }, Qt::QueuedConnection);
+
+        // Czujnik z wartością trafia do modelu od razu, bez czekania na pozostałe;
+        // ostatni pomiar to najnowszy punkt historii
+        if (!values.isEmpty()) {
+            SensorReading reading = sensorIt.value();
+            reading.value = values.valueAt(values.size() - 1);
+            reading.date = GiosDate::format(values.lastTimestamp());
+            reading.unit = values.info().unit;
+            m_sensorDataModel->upsert(reading);
+            m_sensorsUpdated.insert(sensorId);
         }
-        return;
     }
 
-    // Pobieramy identyfikator czujnika z adresu URL
-    QString path = reply->request().url().path();
-    int lastSlash = path.lastIndexOf('/');
-    int sensorId = path.mid(lastSlash + 1).toInt();
-
-    // Pobieramy dane z pierwszego elementu tablicy
-    QJsonObject sensorReading = values[0].toObject();
-    double value = sensorReading["value"].toDouble(-1); // Używamy -1 jako wartości dla NULL
-    QString date = sensorReading["date"].toString();
+    completeSensorRequest();
+}
 
-    // Jeśli nie mamy wartości lub jest NULL, pomijamy ten czujnik
-    if (value < 0 || date.isEmpty()) {
-        // Jeśli to ostatnie żądanie, finalizujemy dane
-        if (m_pendingSensorRequests == 0) {
-            finalizeAndFilterSensorData();
-        }
+void MainWindow::completeSensorRequest() {
+    // Spóźniona odpowiedź po upływie limitu czasu - dane trafiły do modelu,
+    // ale status jest już ustalony
+    if (!m_sensorBatchActive) {
         return;
     }
 
-    // Pobieramy wcześniej zapisane dane czujnika
-    if (m_tempSensorMap.contains(sensorId)) {
-        QVariantMap sensorData = m_tempSensorMap[sensorId].toMap();
+    m_sensorRequestsDone++;
+    emit sensorProgressChanged();
 
-        // Dodajemy dane pomiarowe
-        sensorData["value"] = value;
-        sensorData["date"] = date;
-        sensorData["unit"] = dataObject["key"].toString();
-
-        // Aktualizujemy dane w tymczasowej mapie
-        m_tempSensorMap[sensorId] = sensorData;
+    if (m_sensorRequestsDone >= m_sensorRequestsTotal) {
+        finishSensorBatch(false);
+        return;
     }
 
-    // Jeśli to ostatnie żądanie, finalizujemy dane
-    if (m_pendingSensorRequests == 0) {
-        finalizeAndFilterSensorData();
-    }
+    m_status = QString("Ładowanie danych pomiarowych... (%1/%2)").arg(m_sensorRequestsDone).arg(m_sensorRequestsTotal);
+    emit statusChanged();
 }
 
-void MainWindow::handleSensorHistoryReply(QNetworkReply *reply) {
-    if (reply->error() != QNetworkReply::NoError) {
-        m_status = "Błąd podczas pobierania historii pomiarów: " + reply->errorString();
-        emit statusChanged();
+void MainWindow::handleSensorHistoryReply(int sensorId, const ParsedReply &reply) {
+    // Historia innego czujnika niż aktualnie wybrany - pomijamy
+    if (sensorId != m_selectedSensor["id"].toInt()) {
         return;
     }
 
-    // Parsowanie odpowiedzi JSON
-    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
-    QJsonObject dataObject = doc.object();
-
-    // Pobieramy jednostkę miary
-    QString unit = dataObject["key"].toString();
-
-    // Pobieramy wszystkie wartości historyczne
-    QJsonArray values = dataObject["values"].toArray();
-
-    // Czyszczenie poprzednich danych
-    m_sensorHistory.clear();
-
-    // Przetwarzanie wartości historycznych - od najnowszych do najstarszych
-    for (const QJsonValue &value : values) {
-        QJsonObject reading = value.toObject();
-
-        // Sprawdzamy czy wartość nie jest pusta (null)
-        if (reading["value"].isNull()) {
-            continue;
-        }
-
-        double readingValue = reading["value"].toDouble(-1);
-        QString date = reading["date"].toString();
+    if (reply.error != QNetworkReply::NoError) {
+        m_status = "Błąd podczas pobierania historii pomiarów: " + reply.errorString;
+        emit statusChanged();
+        return;
+    }
 
-        // Jeśli mamy poprawną wartość i datę, dodajemy do historii
-        if (readingValue >= 0 && !date.isEmpty()) {
-            QVariantMap historyItem;
-            historyItem["value"] = readingValue;
-            historyItem["date"] = date;
-            historyItem["unit"] = unit;
+    // Seria w układzie kolumnowym; opis serii jest wspólny
+    TimeSeries history = reply.values;
+    history.info().sensorId = sensorId;
+    history.info().param = m_selectedSensor["param"].toString();
+    history.info().paramFormula = m_selectedSensor["paramFormula"].toString();
+
+    // Do lokalnej historii trafiają tylko nowe punkty; model dostaje całą historię.
+    // Wynik wraca z wątku historii w kolejności zleceń.
+    HistoryStore *store = m_historyStore;
+    QMetaObject::invokeMethod(store, [this, store, sensorId, history]() {
+        int addedCount = 0;
+        const TimeSeries merged = store->merge(history, &addedCount);
+        QMetaObject::invokeMethod(this, [this, sensorId, merged, addedCount]() {
+            showMergedHistory(sensorId, merged, addedCount);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
 
-            m_sensorHistory.append(historyItem);
-        }
+void MainWindow::showMergedHistory(int sensorId, const TimeSeries &merged, int addedCount) {
+    // W międzyczasie wybrano inny czujnik
+    if (sensorId != m_selectedSensor["id"].toInt()) {
+        return;
     }
 
+    m_sensorHistoryModel->setSeries(merged);
+
     // Aktualizacja statusu
-    if (m_sensorHistory.isEmpty()) {
+    if (merged.isEmpty()) {
         m_status = "Brak danych historycznych dla wybranego czujnika";
     } else {
-        m_status = QString("Załadowano %1 pomiarów historycznych").arg(m_sensorHistory.size());
-    }
-
-    // Pobranie jakości powietrza dla stacji (jeśli jeszcze nie pobrano)
-    if (m_airQualityStatus.isEmpty() && m_selectedStationId > 0) {
-        fetchAirQualityStatus(m_selectedStationId);
+        m_status = QString("Załadowano %1 pomiarów historycznych (nowych: %2)").arg(merged.size()).arg(addedCount);
     }
 
     emit sensorHistoryChanged();
     emit statusChanged();
 }
 
-void MainWindow::finalizeAndFilterSensorData() {
-    // Czyszczenie listy danych czujników
-    m_sensorData.clear();
-
-    // Przetwarzamy wszystkie zebrane dane
-    bool dataFound = false;
-
-    QMapIterator<int, QVariant> it(m_tempSensorMap);
-    while (it.hasNext()) {
-        it.next();
-        QVariantMap sensorData = it.value().toMap();
+void MainWindow::finishSensorBatch(bool timedOut) {
+    if (!m_sensorBatchActive) {
+        return;
+    }
 
-        // Dodajemy tylko te czujniki, które mają wartość pomiarową i datę
-        if (sensorData.contains("value") && sensorData.contains("date")) {
-            m_sensorData.append(sensorData);
-            dataFound = true;
+    m_sensorBatchActive = false;
+    m_sensorBatchTimer->stop();
+    emit sensorProgressChanged();
+
+    // Odpowiedziały wszystkie czujniki - wcześniejsze pomiary tych, które
+    // nie podały teraz wartości, są nieaktualne. Po przekroczeniu limitu
+    // czasu zostawiamy je (stary pomiar jest lepszy niż żaden).
+    if (!timedOut) {
+        QList<SensorReading> current;
+        for (const SensorReading &reading : m_sensorDataModel->readings()) {
+            if (m_sensorsUpdated.contains(reading.sensorId)) {
+                current.append(reading);
+            }
+        }
+        if (current.size() != m_sensorDataModel->rowCount()) {
+            m_sensorDataModel->setReadings(current);
         }
     }
 
+    m_session.readings = m_sensorDataModel->readings();
+    saveSession();
+
     // Aktualizacja statusu
-    if (dataFound) {
-        m_status = "Załadowano dane pomiarowe";
-    } else {
+    if (m_sensorDataModel->rowCount() == 0) {
         m_status = "Brak dostępnych danych pomiarowych dla tej stacji";
+    } else if (timedOut) {
+        m_status = QString("Załadowano dane pomiarowe (odpowiedziało %1 z %2 czujników)")
+                       .arg(m_sensorRequestsDone).arg(m_sensorRequestsTotal);
+    } else {
+        m_status = "Załadowano dane pomiarowe";
     }
 
-    // Czyścimy tymczasową mapę
-    m_tempSensorMap.clear();
-
-    // Informujemy o zmianach
-    emit sensorDataChanged();
     emit statusChanged();
 }
 
 void MainWindow::saveSensorDataToJson(const QString &cityName, int stationId) {
     // Sprawdzamy, czy mamy dane historyczne do zapisania
-    if (m_sensorHistory.isEmpty()) {
+    if (m_sensorHistoryModel->rowCount() == 0) {
         m_status = "Brak danych do zapisania";
         emit statusChanged();
         return;
@@ -481,14 +608,13 @@ void MainWindow::saveSensorDataToJson(const QString &cityName, int stationId) {
     // Tworzymy tablicę dla pomiarów
     QJsonArray measurements;
 
-    // Dodajemy każdy pomiar do tablicy
-    for (const QVariant &measurement : m_sensorHistory) {
-        QVariantMap measurementMap = measurement.toMap();
-
+    // Dodajemy każdy pomiar do tablicy - od najnowszych, jak w odpowiedzi API
+    const TimeSeries &history = m_sensorHistoryModel->series();
+    for (int i = history.size() - 1; i >= 0; --i) {
         QJsonObject measurementObj;
-        measurementObj["date"] = measurementMap["date"].toString();
-        measurementObj["value"] = measurementMap["value"].toDouble();
-        measurementObj["unit"] = measurementMap["unit"].toString();
+        measurementObj["date"] = GiosDate::format(history.timestampAt(i));
+        measurementObj["value"] = double(history.valueAt(i));
+        measurementObj["unit"] = history.info().unit;
 
         measurements.append(measurementObj);
     }
@@ -531,4 +657,73 @@ void MainWindow::saveSensorDataToJson(const QString &cityName, int stationId) {
     emit statusChanged();
 }
 
+QVariantMap MainWindow::restoreSession() {
+    QVariantMap view;
+    view["screen"] = 0;
+
+    m_session = m_sessionStore.load();
+    if (m_session.cityName.isEmpty()) {
+        // Pierwsze uruchomienie - pobieramy w tle katalog stacji
+        fetchStations();
+        return view;
+    }
 
+    // Lista stacji z migawki katalogu pojawia się od razu; nieaktualny katalog
+    // jest odświeżany w tle
+    m_cityName = m_session.cityName;
+    emit cityNameChanged();
+    fetchStations();
+
+    if (m_session.screen == 0) {
+        return view;
+    }
+
+    // Ostatnie pomiary i indeks jakości powietrza wybranej stacji z poprzedniej sesji;
+    // odpowiedzi z API nanoszą na nie tylko różnice
+    const SessionState session = m_session;
+    const int stationId = session.station.id;
+    m_selectedStationId = stationId;
+    emit selectedStationIdChanged();
+
+    m_sensorDataModel->setReadings(session.readings);
+    m_airQualityStationId = stationId;
+    m_airQualityStatus = session.airQualityStatus;
+    emit airQualityStatusChanged();
+
+    fetchStationDetails(stationId);
+
+    // Historia czujnika jest wczytywana z HistoryStore, a pobierana tylko wtedy,
+    // gdy jest nieaktualna
+    if (session.screen == 2) {
+        fetchSensorHistory(session.sensorId, session.param, session.paramFormula);
+    }
+
+    view["screen"] = session.screen;
+    view["stationId"] = stationId;
+    view["stationName"] = session.station.name;
+    view["address"] = session.station.address.isEmpty() ? QString("Brak danych") : session.station.address;
+    view["coordinates"] = session.station.lat + ", " + session.station.lon;
+    return view;
+}
+
+void MainWindow::showScreen(int screen) {
+    // Powrót z wykresu lub ze szczegółów stacji - ich dane nie są już potrzebne
+    if (screen < 2) {
+        m_client->cancelRequests("history");
+        m_client->cancelRequests("airQuality");
+    }
+    if (screen < 1) {
+        cancelStationRequests();
+    }
+
+    if (m_session.screen == screen) {
+        return;
+    }
+
+    m_session.screen = screen;
+    saveSession();
+}
+
+void MainWindow::saveSession() {
+    m_sessionStore.save(m_session);
+}
@@ -2,30 +2,50 @@
 #define MAINWINDOW_H
 
 #include <QObject>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QList>
 #include <QVariant>
 #include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+
+#include "giosclient.h"
+#include "stationcatalog.h"
+#include "citysearchindex.h"
+#include "citysuggestionmodel.h"
+#include "stationlistmodel.h"
+#include "sensordatamodel.h"
+#include "sensorhistorymodel.h"
+#include "historystore.h"
+#include "sessionstore.h"
 
 class MainWindow : public QObject {
     Q_OBJECT
-    // Właściwość do przechowywania listy stacji (udostępniana w QML)
-    Q_PROPERTY(QVariantList stations READ stations NOTIFY stationsChanged)
+    // Model listy stacji (udostępniany w QML)
+    Q_PROPERTY(StationListModel *stations READ stations CONSTANT)
     // Właściwość do przechowywania statusu (np. "Ładowanie danych...")
     Q_PROPERTY(QString status READ status NOTIFY statusChanged)
     // Właściwość do przechowywania nazwy miasta
     Q_PROPERTY(QString cityName READ cityName WRITE setCityName NOTIFY cityNameChanged)
-    // Właściwość do przechowywania danych pomiarowych
-    Q_PROPERTY(QVariantList sensorData READ sensorData NOTIFY sensorDataChanged)
-    // Właściwość do przechowywania historii pomiarów dla wybranego czujnika
-    Q_PROPERTY(QVariantList sensorHistory READ sensorHistory NOTIFY sensorHistoryChanged)
+    // Model danych pomiarowych
+    Q_PROPERTY(SensorDataModel *sensorData READ sensorData CONSTANT)
+    // Model historii pomiarów dla wybranego czujnika
+    Q_PROPERTY(SensorHistoryModel *sensorHistory READ sensorHistory CONSTANT)
     // Właściwość do przechowywania informacji o aktualnie wybranym czujniku
     Q_PROPERTY(QVariantMap selectedSensor READ selectedSensor NOTIFY selectedSensorChanged)
 
     //Właściwość do przechwytywania informacji o aktualnym stanie powietrza
     Q_PROPERTY(QString airQualityStatus READ airQualityStatus NOTIFY airQualityStatusChanged)
 
+    // Podpowiedzi nazw miast w trakcie pisania
+    Q_PROPERTY(CitySuggestionModel *citySuggestions READ citySuggestions CONSTANT)
+
+    // Postęp pobierania danych czujników wybranej stacji
+    Q_PROPERTY(bool sensorsLoading READ sensorsLoading NOTIFY sensorProgressChanged)
+    Q_PROPERTY(int sensorRequestsDone READ sensorRequestsDone NOTIFY sensorProgressChanged)
+    Q_PROPERTY(int sensorRequestsTotal READ sensorRequestsTotal NOTIFY sensorProgressChanged)
+
     // Dodaj to do sekcji Q_PROPERTY:
     Q_PROPERTY(int selectedStationId READ selectedStationId WRITE setSelectedStationId NOTIFY selectedStationIdChanged)
 
@@ -43,14 +63,18 @@ public:
     ~MainWindow();
 
     // Gettery dla właściwości
-    QVariantList stations() const { return m_stations; }
+    StationListModel *stations() const { return m_stationModel; }
     QString status() const { return m_status; }
     QString cityName() const { return m_cityName; }
-    QVariantList sensorData() const { return m_sensorData; }
-    QVariantList sensorHistory() const { return m_sensorHistory; }
+    SensorDataModel *sensorData() const { return m_sensorDataModel; }
+    SensorHistoryModel *sensorHistory() const { return m_sensorHistoryModel; }
     QVariantMap selectedSensor() const { return m_selectedSensor; }
     //stan powietrza
     QString airQualityStatus() const { return m_airQualityStatus; }
+    CitySuggestionModel *citySuggestions() const { return m_citySuggestions; }
+    bool sensorsLoading() const { return m_sensorBatchActive; }
+    int sensorRequestsDone() const { return m_sensorRequestsDone; }
+    int sensorRequestsTotal() const { return m_sensorRequestsTotal; }
 
     // Setter dla miasta
     void setCityName(const QString &cityName);
@@ -69,62 +93,88 @@ public slots:
 
     Q_INVOKABLE void fetchAirQualityForStation(int stationId);
 
+    // Odtwarza ostatni stan widoku z danych zapisanych lokalnie i odświeża je w tle.
+    // Zwraca ekran i dane stacji do pokazania (screen, stationId, stationName, address, coordinates).
+    Q_INVOKABLE QVariantMap restoreSession();
+    // Ekran widoczny w QML (0 - lista stacji, 1 - szczegóły, 2 - historia):
+    // zapamiętuje go w sesji i anuluje żądania ekranów, które zostały zamknięte
+    Q_INVOKABLE void showScreen(int screen);
+
 signals:
     // Sygnały informujące o zmianie danych
-    void stationsChanged();
     void statusChanged();
     void cityNameChanged();
-    void sensorDataChanged();
+    // Załadowano (lub wyczyszczono) historię wybranego czujnika
     void sensorHistoryChanged();
     void selectedSensorChanged();
 
     void selectedStationIdChanged();
     //stan powietrza
     void airQualityStatusChanged();
+    void sensorProgressChanged();
 
 private slots:
-    // Slot do obsługi odpowiedzi z API
-    void onNetworkReply(QNetworkReply *reply);
-    // Metody do obsługi różnych typów odpowiedzi
-    void handleStationDetailsReply(QNetworkReply *reply);
-    void handleSensorDataReply(QNetworkReply *reply);
-    void handleStationListReply(QNetworkReply *reply);
-    void handleSensorHistoryReply(QNetworkReply *reply);
-    void handleAirQualityResponse(QNetworkReply *reply);
-    void fetchSensorDataForParam(int sensorId);
+    void fetchSensorDataForParam(int sensorId, int stationId);
     void fetchAirQualityStatus(int stationId);
 
-    // Nowa metoda do finalizacji i filtrowania danych z czujników
-    void finalizeAndFilterSensorData();
+    // Zakończenie pobierania danych czujników (wszystkie odpowiedzi lub limit czasu)
+    void finishSensorBatch(bool timedOut);
 
 private:
-    QNetworkAccessManager *m_networkManager;
-    QVariantList m_stations;     // Lista stacji w formacie QVariantList (dla QML)
+    GiosClient *m_client;        // Zapytania do API i parsowanie odpowiedzi
     QString m_status;            // Status ładowania
     QString m_cityName;          // Nazwa miasta
-    QVariantList m_sensorData;   // Dane pomiarowe
-    QVariantList m_sensorHistory; // Historia pomiarów dla wybranego czujnika
     QVariantMap m_selectedSensor; // Informacje o wybranym czujniku
 
     int m_selectedStationId; // ID wybranej stacji
+    int m_detailsStationId;  // ID stacji, dla której pobierane są szczegóły
 
-    // Nowe pola do obsługi asynchronicznego pobierania danych
-    QMap<int, QVariant> m_tempSensorMap;  // Tymczasowa mapa do zbierania danych z czujników
-    int m_pendingSensorRequests;          // Licznik oczekujących żądań
+    // Pola do obsługi asynchronicznego pobierania danych czujników
+    QHash<int, SensorReading> m_sensorMeta; // Opis czujników stacji (bez wartości)
+    int m_sensorRequestsTotal;              // Liczba wysłanych żądań
+    int m_sensorRequestsDone;               // Liczba otrzymanych odpowiedzi
+    bool m_sensorBatchActive;               // Czy czekamy jeszcze na odpowiedzi
+    QSet<int> m_sensorsUpdated;             // Czujniki z nową wartością w bieżącym pobieraniu
+    QTimer *m_sensorBatchTimer;             // Limit czasu na odpowiedzi
 
 
     QString m_airQualityStatus; //Stan powietrza
-
-    // Enum do śledzenia typu zapytania
-    enum RequestType {
-        StationList,
-        StationDetails,
-        SensorData,
-        SensorHistory,
-        AirQualityIndex
-    };
-
-    RequestType m_currentRequestType;
+    int m_airQualityStationId;  // Stacja, której dotyczy m_airQualityStatus
+
+    StationCatalog m_catalog;      // Katalog wszystkich stacji z indeksem miast
+    bool m_catalogRequestPending;  // Czy pobieranie katalogu jest w toku
+    CitySearchIndex m_citySearchIndex;          // Indeks nazw miast (prefiksy, literówki)
+    CitySuggestionModel *m_citySuggestions;     // Podpowiedzi dla pola wyszukiwania
+
+    StationListModel *m_stationModel;           // Stacje w wybranym mieście
+    SensorDataModel *m_sensorDataModel;         // Ostatnie pomiary czujników stacji
+    SensorHistoryModel *m_sensorHistoryModel;   // Historia pomiarów wybranego czujnika
+    QThread *m_historyThread;                   // Wątek odczytu i zapisu historii
+    HistoryStore *m_historyStore;               // Historia czujników zapisana na dysku (żyje w m_historyThread)
+    SessionStore m_sessionStore;                // Ostatni stan widoku zapisany na dysku
+    SessionState m_session;                     // Bieżący stan widoku (zapisywany po każdej zmianie)
+
+    // Pobiera katalog stacji (jeśli nie jest już pobierany)
+    void requestStationCatalog();
+    // Wypełnia listę stacji dla bieżącego miasta na podstawie katalogu
+    void showStationsForCity();
+    // Odnotowuje odpowiedź jednego czujnika i aktualizuje postęp
+    void completeSensorRequest();
+    // Zapisuje m_session na dysk
+    void saveSession();
+    // Anuluje pobieranie danych wybranej stacji i kończy oczekiwanie na czujniki
+    void cancelStationRequests();
+
+    // Metody do obsługi różnych typów odpowiedzi (sygnały GiosClient).
+    // Obie obsługi getData dostają te same, raz sparsowane pomiary.
+    void handleStationListReply(const ParsedReply &reply);
+    void handleStationDetailsReply(int stationId, const ParsedReply &reply);
+    void handleAirQualityResponse(int stationId, const ParsedReply &reply);
+    void handleSensorDataReply(int sensorId, int stationId, const ParsedReply &reply);
+    void handleSensorHistoryReply(int sensorId, const ParsedReply &reply);
+    // Wyniki pracy wątku historii dla wybranego czujnika
+    void showStoredHistory(int sensorId, TimeSeries stored, qint64 lastFetched);
+    void showMergedHistory(int sensorId, const TimeSeries &merged, int addedCount);
 };
 
 #endif // MAINWINDOW_H
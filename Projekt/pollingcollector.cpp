@@ -0,0 +1,270 @@
+#include "pollingcollector.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+static const qint64 HourMs = 60 * 60 * 1000;
+// Pomiary z pełnej godziny pojawiają się w API z kilkuminutowym opóźnieniem
+static const qint64 PublishDelayMs = 5 * 60 * 1000;
+// Odstęp ponowień dla czujników, którym brakuje pomiaru z bieżącej godziny
+static const int RetryIntervalMs = 15 * 60 * 1000;
+// Czujnik pobrany niedawno pomijamy - także przez okno aplikacji, bo HistoryStore
+// wczytuje pliki zmienione przez inny proces
+static const qint64 MinRefetchMs = 10 * 60 * 1000;
+static const int DefaultJitterMs = 10 * 60 * 1000;
+
+PollingCollector::PollingCollector(GiosClient *client, HistoryStore *historyStore, QObject *parent)
+    : QObject(parent),
+    m_client(client),
+    m_historyStore(historyStore),
+    m_jitterMs(DefaultJitterMs),
+    m_hourStart(0),
+    m_retryPass(false),
+    m_passRunning(false),
+    m_pending(0),
+    m_fetched(0),
+    m_updated(0),
+    m_stillDue(0) {
+
+    connect(m_client, &GiosClient::stationListReceived, this, &PollingCollector::handleStationList);
+    connect(m_client, &GiosClient::stationSensorsReceived, this, &PollingCollector::handleStationSensors);
+    connect(m_client, &GiosClient::sensorDataReceived, this, &PollingCollector::handleSensorData);
+
+    m_passTimer.setSingleShot(true);
+    connect(&m_passTimer, &QTimer::timeout, this, &PollingCollector::runPass);
+
+    // Ten sam katalog stacji co w oknie aplikacji
+    m_catalog.setSnapshotPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                              + "/catalog.bin");
+}
+
+void PollingCollector::start() {
+    m_retryPass = false;
+    runPass();
+}
+
+void PollingCollector::runPass() {
+    // Poprzedni przebieg jeszcze czeka na odpowiedzi - następny zaplanuje on sam
+    if (m_passRunning) {
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_hourStart = now - now % HourMs;
+    m_passRunning = true;
+    m_passStations.clear();
+    m_passSensors.clear();
+    m_fetched = 0;
+    m_updated = 0;
+    m_stillDue = 0;
+
+    // Przebieg kończy się dopiero po wysłaniu wszystkich żądań
+    m_pending = 1;
+
+    if (!m_jobs.cities.isEmpty() || m_jobs.allStations) {
+        if (m_catalog.isEmpty()) {
+            m_catalog.loadSnapshot();
+        }
+        // Katalog zmienia się rzadko - odświeżamy go tylko w przebiegu godzinowym
+        if (m_catalog.isEmpty() || (!m_retryPass && !m_catalog.isFresh())) {
+            m_pending++;
+            m_client->fetchStationList(RequestScheduler::Background);
+        } else {
+            resolveCatalogJobs();
+        }
+    }
+
+    for (int stationId : std::as_const(m_jobs.stations)) {
+        refreshStation(stationId);
+    }
+    for (int sensorId : std::as_const(m_jobs.sensors)) {
+        refreshSensor(sensorId, 0);
+    }
+
+    completeRequest();
+}
+
+void PollingCollector::handleStationList(const ParsedReply &reply) {
+    if (!m_passRunning) {
+        return;
+    }
+
+    if (reply.error == QNetworkReply::NoError) {
+        m_catalog.setSnapshot(reply.catalogSnapshot);
+    } else {
+        qWarning().noquote() << "Błąd podczas pobierania katalogu stacji:" << reply.errorString;
+    }
+
+    resolveCatalogJobs();
+    completeRequest();
+}
+
+void PollingCollector::resolveCatalogJobs() {
+    if (m_catalog.isEmpty()) {
+        return;
+    }
+
+    QStringList missingCities;
+    const QList<int> stations = stationsForJobs(m_jobs, m_catalog, &missingCities);
+    for (const QString &cityName : std::as_const(missingCities)) {
+        qWarning().noquote() << "Nie znaleziono stacji w mieście:" << cityName;
+    }
+    for (int stationId : stations) {
+        refreshStation(stationId);
+    }
+}
+
+void PollingCollector::refreshStation(int stationId) {
+    if (m_passStations.contains(stationId)) {
+        return;
+    }
+    m_passStations.insert(stationId);
+
+    // Ponowienie korzysta ze znanej listy czujników; w przebiegu godzinowym lista
+    // jest odświeżana (zwykle z pamięci podręcznej odpowiedzi)
+    const auto sensorsIt = m_stationSensors.constFind(stationId);
+    if (m_retryPass && sensorsIt != m_stationSensors.constEnd()) {
+        for (const SensorReading &sensor : *sensorsIt) {
+            refreshSensor(sensor.sensorId, stationId);
+        }
+        return;
+    }
+
+    m_pending++;
+    m_client->fetchStationSensors(stationId, RequestScheduler::Background);
+}
+
+void PollingCollector::refreshSensor(int sensorId, int stationId) {
+    if (m_passSensors.contains(sensorId)) {
+        return;
+    }
+    m_passSensors.insert(sensorId);
+
+    if (!isDue(sensorId)) {
+        return;
+    }
+    m_pending++;
+    m_fetched++;
+    m_client->fetchSensorData(sensorId, stationId, RequestScheduler::Background);
+}
+
+bool PollingCollector::isDue(int sensorId) {
+    if (QDateTime::currentMSecsSinceEpoch() - m_historyStore->lastFetched(sensorId) < MinRefetchMs) {
+        return false;
+    }
+
+    const qint64 latest = m_historyStore->load(sensorId).lastTimestamp();
+    if (latest >= m_hourStart) {
+        return false;
+    }
+    // Ponawiamy tylko czujniki, które miały pomiar z poprzedniej godziny - czujnik
+    // od dawna bez pomiarów (awaria, wyłączenie) sprawdzamy raz na godzinę
+    return !m_retryPass || latest >= m_hourStart - HourMs;
+}
+
+void PollingCollector::handleStationSensors(int stationId, const ParsedReply &reply) {
+    if (!m_passRunning || !m_passStations.contains(stationId)) {
+        return;
+    }
+
+    // Przy błędzie korzystamy z listy czujników z poprzedniego przebiegu
+    if (reply.error == QNetworkReply::NoError) {
+        m_stationSensors.insert(stationId, reply.sensors);
+    } else {
+        qWarning().noquote() << QString("Błąd podczas pobierania czujników stacji %1: %2")
+                                    .arg(stationId).arg(reply.errorString);
+    }
+
+    const QList<SensorReading> sensors = m_stationSensors.value(stationId);
+    for (const SensorReading &sensor : sensors) {
+        refreshSensor(sensor.sensorId, stationId);
+    }
+    completeRequest();
+}
+
+void PollingCollector::handleSensorData(int sensorId, int stationId, const ParsedReply &reply) {
+    if (!m_passRunning || !m_passSensors.contains(sensorId)) {
+        return;
+    }
+
+    if (reply.error != QNetworkReply::NoError) {
+        qWarning().noquote() << QString("Błąd podczas pobierania pomiarów czujnika %1: %2")
+                                    .arg(sensorId).arg(reply.errorString);
+        m_stillDue++;
+        completeRequest();
+        return;
+    }
+
+    TimeSeries series = reply.values;
+    series.info().sensorId = sensorId;
+
+    // Opis czujnika z listy czujników stacji albo z zapisanej historii
+    const SeriesInfo stored = m_historyStore->load(sensorId).info();
+    series.info().param = stored.param;
+    series.info().paramFormula = stored.paramFormula;
+    for (const SensorReading &sensor : m_stationSensors.value(stationId)) {
+        if (sensor.sensorId == sensorId) {
+            series.info().param = sensor.param;
+            series.info().paramFormula = sensor.paramFormula;
+            break;
+        }
+    }
+
+    int addedCount = 0;
+    bool saved = false;
+    const TimeSeries merged = m_historyStore->merge(series, &addedCount, &saved);
+    if (!saved) {
+        // Niezapisane pomiary ponawiamy jak błąd sieci
+        qWarning().noquote() << QString("Nie udało się zapisać historii czujnika %1").arg(sensorId);
+        m_stillDue++;
+        completeRequest();
+        return;
+    }
+    if (addedCount > 0) {
+        m_updated++;
+    }
+    // Czujnik bez pomiaru z poprzedniej godziny i tak nie zostanie ponowiony (isDue)
+    const qint64 latest = merged.lastTimestamp();
+    if (latest < m_hourStart && latest >= m_hourStart - HourMs) {
+        m_stillDue++;
+    }
+    completeRequest();
+}
+
+void PollingCollector::completeRequest() {
+    if (--m_pending > 0) {
+        return;
+    }
+
+    m_passRunning = false;
+    qCDebug(lcCollector) << "Przebieg zakończony; stacje:" << m_passStations.size()
+                         << "pobrane czujniki:" << m_fetched << "z nowymi pomiarami:" << m_updated
+                         << "bez pomiaru z bieżącej godziny:" << m_stillDue;
+
+    // Między przebiegami historia nie jest potrzebna w pamięci - przy wszystkich
+    // stacjach byłyby to pełne serie każdego czujnika
+    m_historyStore->releaseSeries();
+    emit passFinished(m_fetched, m_updated);
+    scheduleNextPass();
+}
+
+void PollingCollector::scheduleNextPass() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 nextHour = m_hourStart + HourMs;
+
+    // Spóźnione pomiary ponawiamy, dopóki zostaje czas w tej samej godzinie
+    if (m_stillDue > 0 && now + RetryIntervalMs < nextHour) {
+        m_retryPass = true;
+        m_passTimer.start(RetryIntervalMs);
+        return;
+    }
+
+    // Losowe przesunięcie rozkłada zapytania wielu instancji w czasie
+    const qint64 jitter = m_jitterMs > 0 ? QRandomGenerator::global()->bounded(m_jitterMs) : 0;
+    const qint64 nextPass = nextHour + PublishDelayMs + jitter;
+    m_retryPass = false;
+    m_passTimer.start(int(qMax<qint64>(nextPass - now, 0)));
+    qCDebug(lcCollector) << "Następny przebieg:" << QDateTime::fromMSecsSinceEpoch(nextPass).toString("HH:mm:ss");
+}
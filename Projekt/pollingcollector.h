@@ -0,0 +1,71 @@
+#ifndef POLLINGCOLLECTOR_H
+#define POLLINGCOLLECTOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+
+#include "batchcollector.h"
+
+// Stałe odświeżanie obserwowanych stacji (stacje_pomiarowe --headless --daemon).
+// GIOŚ publikuje pomiary raz na godzinę, więc przebieg zaczyna się kilka minut po
+// pełnej godzinie (plus losowe przesunięcie, żeby wiele instancji nie pytało API
+// w tej samej chwili). Pobierane są tylko czujniki, którym brakuje pomiaru z bieżącej
+// godziny; spóźnione pomiary są ponawiane co kwadrans do końca godziny.
+// Nowe pomiary trafiają do lokalnej historii (HistoryStore).
+class PollingCollector : public QObject {
+    Q_OBJECT
+
+public:
+    PollingCollector(GiosClient *client, HistoryStore *historyStore, QObject *parent = nullptr);
+
+    void setJobs(const CollectorJobs &jobs) { m_jobs = jobs; }
+    // Górna granica losowego przesunięcia przebiegu po pełnej godzinie
+    void setJitter(int jitterMs) { m_jitterMs = jitterMs; }
+
+    // Pierwszy przebieg od razu, kolejne według harmonogramu
+    void start();
+
+signals:
+    // fetched - pobrane czujniki, updated - czujniki z nowymi pomiarami
+    void passFinished(int fetched, int updated);
+
+private:
+    void handleStationList(const ParsedReply &reply);
+    void handleStationSensors(int stationId, const ParsedReply &reply);
+    void handleSensorData(int sensorId, int stationId, const ParsedReply &reply);
+
+    // Przebieg: czujniki wszystkich obserwowanych stacji, którym brakuje pomiarów
+    void runPass();
+    // Stacje zadanych miast (lub wszystkie) według katalogu
+    void resolveCatalogJobs();
+    void refreshStation(int stationId);
+    void refreshSensor(int sensorId, int stationId);
+    // Czy czujnik czeka na pomiar z bieżącej godziny
+    bool isDue(int sensorId);
+    void completeRequest();
+    // Następny przebieg: ponowienie w tej samej godzinie albo po następnej pełnej godzinie
+    void scheduleNextPass();
+
+    GiosClient *m_client;
+    HistoryStore *m_historyStore;
+    StationCatalog m_catalog;
+    CollectorJobs m_jobs;
+    int m_jitterMs;
+    QTimer m_passTimer;
+
+    QHash<int, QList<SensorReading>> m_stationSensors; // Czujniki stacji z ostatniej odpowiedzi
+    QSet<int> m_passStations;      // Stacje i czujniki pobierane w bieżącym przebiegu
+    QSet<int> m_passSensors;
+    qint64 m_hourStart;            // Początek godziny bieżącego przebiegu (ms od epoki)
+    bool m_retryPass;              // Ponowienie w tej samej godzinie (tylko spóźnione czujniki)
+    bool m_passRunning;
+    int m_pending;                 // Żądania przebiegu bez odpowiedzi
+    int m_fetched;                 // Czujniki pobrane w przebiegu
+    int m_updated;                 // Czujniki z nowymi pomiarami w przebiegu
+    int m_stillDue;                // Czujniki, którym po przebiegu nadal brakuje pomiaru
+};
+
+#endif // POLLINGCOLLECTOR_H
@@ -8,10 +8,62 @@ TARGET = stacje_pomiarowe
 
 SOURCES += \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    giosclient.cpp \
+    batchcollector.cpp \
+    pollingcollector.cpp \
+    headless.cpp \
+    requestscheduler.cpp \
+    responsecache.cpp \
+    replyparser.cpp \
+    jsontokenizer.cpp \
+    stationlistreader.cpp \
+    stationcatalog.cpp \
+    catalogsnapshot.cpp \
+    citysearchindex.cpp \
+    citysuggestionmodel.cpp \
+    stationlistmodel.cpp \
+    sensordatamodel.cpp \
+    sensorhistorymodel.cpp \
+    linechartitem.cpp \
+    downsampler.cpp \
+    chartlabelmodel.cpp \
+    timeseries.cpp \
+    historystore.cpp \
+    sessionstore.cpp \
+    seriescodec.cpp \
+    giosdate.cpp \
+    giosdecoders.cpp \
+    benchmark.cpp
 
 HEADERS += \
-    mainwindow.h
+    mainwindow.h \
+    giosclient.h \
+    batchcollector.h \
+    pollingcollector.h \
+    headless.h \
+    requestscheduler.h \
+    responsecache.h \
+    replyparser.h \
+    jsontokenizer.h \
+    stationlistreader.h \
+    stationcatalog.h \
+    catalogsnapshot.h \
+    citysearchindex.h \
+    citysuggestionmodel.h \
+    stationlistmodel.h \
+    sensordatamodel.h \
+    sensorhistorymodel.h \
+    linechartitem.h \
+    downsampler.h \
+    chartlabelmodel.h \
+    timeseries.h \
+    historystore.h \
+    sessionstore.h \
+    seriescodec.h \
+    giosdate.h \
+    giosdecoders.h \
+    benchmark.h
 
 RESOURCES += \
     qml.qrc
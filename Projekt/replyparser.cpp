@@ -0,0 +1,75 @@
+#include "replyparser.h"
+#include "catalogsnapshot.h"
+#include "giosdecoders.h"
+#include <QDateTime>
+
+ReplyParser::ReplyParser(QObject *parent)
+    : QObject(parent) {
+}
+
+void ReplyParser::parse(ParsedReply reply, const QByteArray &body) {
+    // Strumień kończy się razem z odpowiedzią
+    StationListReader reader = m_streams.take(reply.stream);
+
+    if (reply.error == QNetworkReply::NoError) {
+        switch (reply.kind) {
+        case ParsedReply::StationList:
+            // Niepoprawny katalog traktujemy jak błąd - zostaje poprzedni
+            if (!reader.feed(body) || !reader.finish()) {
+                reply.error = QNetworkReply::UnknownContentError;
+                reply.errorString = QStringLiteral("Niepoprawna odpowiedź z katalogiem stacji");
+                break;
+            }
+            reply.stations = reader.stations();
+
+            // Migawkę katalogu i indeks miast budujemy tutaj - wątek GUI tylko je podmienia
+            reply.catalogSnapshot = CatalogSnapshot::build(reply.stations, QDateTime::currentMSecsSinceEpoch());
+            reply.cityIndex.build(reply.stations);
+            break;
+        case ParsedReply::StationSensors:
+            reply.sensors = parseStationSensors(body);
+            break;
+        case ParsedReply::SensorValues:
+            reply.values = parseSensorValues(body);
+            break;
+        case ParsedReply::AirQualityIndex:
+            reply.hasAirQualityData = parseAirQualityIndex(body, &reply.airQualityLevel);
+            break;
+        }
+    }
+
+    emit parsed(reply);
+}
+
+void ReplyParser::feedStream(quintptr stream, const QByteArray &chunk) {
+    // Błąd składni zostanie zgłoszony w parse(), po zakończeniu odpowiedzi
+    m_streams[stream].feed(chunk);
+}
+
+void ReplyParser::discardStream(quintptr stream) {
+    m_streams.remove(stream);
+}
+
+QList<SensorReading> ReplyParser::parseStationSensors(const QByteArray &body) {
+    // Niepoprawna odpowiedź - stacja bez czujników
+    QList<SensorReading> sensors;
+    if (!GiosDecoders::decodeStationSensors(body, &sensors)) {
+        sensors.clear();
+    }
+    return sensors;
+}
+
+TimeSeries ReplyParser::parseSensorValues(const QByteArray &body) {
+    // Niepoprawna odpowiedź - pusta seria
+    TimeSeries series;
+    if (!GiosDecoders::decodeSensorValues(body, &series)) {
+        series = TimeSeries();
+    }
+    return series;
+}
+
+bool ReplyParser::parseAirQualityIndex(const QByteArray &body, QString *indexLevel) {
+    // Niepoprawna odpowiedź traktujemy jak brak danych
+    bool hasData = false;
+    return GiosDecoders::decodeAirQualityIndex(body, &hasData, indexLevel) && hasData;
+}
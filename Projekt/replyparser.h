@@ -0,0 +1,85 @@
+#ifndef REPLYPARSER_H
+#define REPLYPARSER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include "stationcatalog.h"
+#include "citysearchindex.h"
+#include "sensordatamodel.h"
+#include "timeseries.h"
+#include "stationlistreader.h"
+
+// Odpowiedź API zamieniona na gotowe rekordy (wynik ReplyParser)
+struct ParsedReply {
+    // Rodzaj odpowiedzi - wynika z adresu zapytania
+    enum Kind {
+        StationList,     // station/findAll
+        StationSensors,  // station/sensors/{id}
+        SensorValues,    // data/getData/{id}
+        AirQualityIndex  // aqindex/getIndex/{id}
+    };
+
+    Kind kind = StationList;
+    QList<QNetworkRequest> requests;  // Żądania obsłużone tą odpowiedzią
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+    QString errorString;
+    // Strumień, do którego trafiały fragmenty odpowiedzi w trakcie pobierania
+    // (feedStream); 0 - treść jest tylko w body przekazanym do parse()
+    quintptr stream = 0;
+
+    // station/findAll: stacje, gotowa migawka katalogu i indeks nazw miast
+    QList<StationRecord> stations;
+    QByteArray catalogSnapshot;
+    CitySearchIndex cityIndex;
+    // station/sensors: czujniki stacji (bez wartości), position - kolejność w odpowiedzi
+    QList<SensorReading> sensors;
+    // data/getData: pomiary posortowane rosnąco (bez wartości null), z jednostką
+    TimeSeries values;
+    // aqindex/getIndex: czy odpowiedź zawiera dane i nazwa poziomu indeksu
+    bool hasAirQualityData = false;
+    QString airQualityLevel;
+};
+
+Q_DECLARE_METATYPE(ParsedReply)
+
+// Parsowanie odpowiedzi API poza wątkiem GUI. Obiekt żyje w osobnym wątku,
+// parse() jest wywoływane w tym wątku (wywołanie kolejkowane), a gotowe rekordy
+// wracają sygnałem parsed() do wątku odbiorcy. Odpowiedzi są przetwarzane
+// w kolejności, w jakiej zostały przekazane. Katalog stacji jest czytany
+// przyrostowo już w trakcie pobierania (feedStream), bez drzewa JSON; pozostałe
+// odpowiedzi czytają dekodery GiosDecoders prosto z bajtów treści.
+class ReplyParser : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ReplyParser(QObject *parent = nullptr);
+
+    // Parsuje treść odpowiedzi (przy błędzie sieci przekazuje opis dalej) i emituje parsed().
+    // Dla strumienia body to ostatni, jeszcze nieprzekazany fragment.
+    void parse(ParsedReply reply, const QByteArray &body);
+
+    // Kolejny fragment pobieranego katalogu stacji
+    void feedStream(quintptr stream, const QByteArray &chunk);
+    // Porzuca strumień (żądanie anulowane lub odpowiedź już obsłużona)
+    void discardStream(quintptr stream);
+
+    // Funkcje parsujące - bez stanu, można ich używać w dowolnym wątku
+    static QList<SensorReading> parseStationSensors(const QByteArray &body);
+    static TimeSeries parseSensorValues(const QByteArray &body);
+    // false, jeśli odpowiedź nie zawiera danych; indexLevel może być pusty
+    static bool parseAirQualityIndex(const QByteArray &body, QString *indexLevel);
+
+signals:
+    void parsed(const ParsedReply &reply);
+
+private:
+    QHash<quintptr, StationListReader> m_streams;
+};
+
+#endif // REPLYPARSER_H
@@ -0,0 +1,269 @@
+#include "requestscheduler.h"
+#include "responsecache.h"
+#include <QAbstractNetworkCache>
+#include <QLoggingCategory>
+
+// Przebieg żądań przez kolejkę - domyślnie wyłączony, włączany przez
+// QT_LOGGING_RULES="stacje.scheduler.debug=true"
+Q_LOGGING_CATEGORY(lcScheduler, "stacje.scheduler", QtWarningMsg)
+
+RequestScheduler::RequestScheduler(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent),
+    m_manager(manager),
+    m_maxConcurrentPerHost(4),
+    m_nextId(1),
+    m_totalWaitMs(0),
+    m_maxWaitMs(0),
+    m_startedCount(0),
+    m_cacheHits(0),
+    m_cacheMisses(0),
+    m_cacheRevalidations(0),
+    m_coalescedCount(0) {
+}
+
+quint64 RequestScheduler::enqueue(const QNetworkRequest &request, Priority priority, const QString &group) {
+    // Ten sam adres jest już pobierany - nie wysyłamy go drugi raz
+    quint64 attachedId = 0;
+    if (attach(request, priority, group, &attachedId)) {
+        m_coalescedCount++;
+        emit statsChanged();
+        return attachedId;
+    }
+
+    Job job;
+    job.id = m_nextId++;
+    job.request = request;
+    job.priority = priority;
+    job.subscribers.append({request, group});
+    job.host = request.url().host();
+    job.queuedTimer.start();
+
+    m_queues[priority].append(job);
+
+    dispatch();
+    emit statsChanged();
+
+    return job.id;
+}
+
+void RequestScheduler::cancelGroup(const QString &group) {
+    if (group.isEmpty()) {
+        return;
+    }
+
+    // Usuwamy oczekujące żądania z grupy
+    for (QList<Job> &queue : m_queues) {
+        for (int i = 0; i < queue.size();) {
+            if (removeSubscribers(queue[i], group)) {
+                queue.removeAt(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    // Przerywamy żądania w toku, na które czekała tylko ta grupa - najpierw
+    // zdejmujemy je z listy aktywnych, żeby onReplyFinished nie przekazał ich dalej
+    QList<QNetworkReply *> toAbort;
+    for (auto it = m_active.begin(); it != m_active.end();) {
+        if (removeSubscribers(it.value(), group)) {
+            m_activePerHost[it.value().host]--;
+            toAbort.append(it.key());
+            it = m_active.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (QNetworkReply *reply : toAbort) {
+        reply->abort();
+    }
+
+    // Zwolnione miejsca mogą zająć kolejne żądania
+    dispatch();
+    emit statsChanged();
+}
+
+void RequestScheduler::setMaxConcurrentPerHost(int max) {
+    m_maxConcurrentPerHost = qMax(1, max);
+    dispatch();
+}
+
+int RequestScheduler::queueDepth() const {
+    int depth = 0;
+    for (const QList<Job> &queue : m_queues) {
+        depth += queue.size();
+    }
+    return depth;
+}
+
+double RequestScheduler::averageWaitMs() const {
+    if (m_startedCount == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(m_totalWaitMs) / m_startedCount;
+}
+
+void RequestScheduler::resetStats() {
+    m_totalWaitMs = 0;
+    m_maxWaitMs = 0;
+    m_startedCount = 0;
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_cacheRevalidations = 0;
+    m_coalescedCount = 0;
+    emit statsChanged();
+}
+
+void RequestScheduler::dispatch() {
+    // Przechodzimy kolejki od najwyższego priorytetu; żądanie do hosta, który
+    // osiągnął limit, nie blokuje żądań do innych hostów
+    for (QList<Job> &queue : m_queues) {
+        for (int i = 0; i < queue.size();) {
+            if (m_activePerHost.value(queue[i].host) < m_maxConcurrentPerHost) {
+                start(queue.takeAt(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+}
+
+void RequestScheduler::start(Job job) {
+    const qint64 waitMs = job.queuedTimer.elapsed();
+    m_totalWaitMs += waitMs;
+    m_maxWaitMs = qMax(m_maxWaitMs, waitMs);
+    m_startedCount++;
+
+    m_activePerHost[job.host]++;
+
+    job.cacheLookup = lookupCache(job.request);
+    QNetworkReply *reply = m_manager->get(job.request);
+    m_active.insert(reply, job);
+
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        onReplyFinished(reply);
+    });
+    emit replyStarted(reply, job.subscribers.first().request);
+
+    qCDebug(lcScheduler) << "start" << job.request.url().path()
+                         << "priorytet:" << job.priority
+                         << "oczekiwanie:" << waitMs << "ms"
+                         << "kolejka:" << queueDepth()
+                         << "w toku:" << m_active.size()
+                         << "cache:" << job.cacheLookup;
+}
+
+RequestScheduler::CacheLookup RequestScheduler::lookupCache(QNetworkRequest &request) const {
+    QAbstractNetworkCache *cache = m_manager->cache();
+    if (!cache) {
+        return NotCached;
+    }
+
+    const QNetworkCacheMetaData metaData = cache->metaData(request.url());
+    if (!metaData.isValid()) {
+        return NotCached;
+    }
+
+    // Nieaktualny wpis sprawdza QNetworkAccessManager zapytaniem warunkowym
+    if (!ResponseCache::isFresh(metaData)) {
+        return CachedStale;
+    }
+
+    // Świeży wpis podajemy bez pytania serwera, chyba że żądanie mówi inaczej
+    if (!request.attribute(QNetworkRequest::CacheLoadControlAttribute).isValid()) {
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+    }
+    return CachedFresh;
+}
+
+void RequestScheduler::countCacheResult(const Job &job, QNetworkReply *reply) {
+    if (reply->error() != QNetworkReply::NoError) {
+        return;
+    }
+
+    if (!reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        m_cacheMisses++;
+    } else if (job.cacheLookup == CachedStale) {
+        m_cacheRevalidations++;
+    } else {
+        m_cacheHits++;
+    }
+}
+
+bool RequestScheduler::attach(const QNetworkRequest &request, Priority priority, const QString &group, quint64 *id) {
+    const QUrl url = request.url();
+
+    for (Job &job : m_active) {
+        if (job.request.url() == url) {
+            addSubscriber(job, request, group);
+            *id = job.id;
+            return true;
+        }
+    }
+
+    for (int queueIndex = 0; queueIndex < PriorityCount; ++queueIndex) {
+        QList<Job> &queue = m_queues[queueIndex];
+        for (int i = 0; i < queue.size(); ++i) {
+            if (queue[i].request.url() != url) {
+                continue;
+            }
+
+            addSubscriber(queue[i], request, group);
+            *id = queue[i].id;
+
+            // Pilniejsze żądanie przenosi oczekujące pobieranie do wyższej kolejki
+            if (priority < queueIndex) {
+                Job job = queue.takeAt(i);
+                job.priority = priority;
+                m_queues[priority].append(job);
+                dispatch();
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RequestScheduler::addSubscriber(Job &job, const QNetworkRequest &request, const QString &group) {
+    // Identyczne żądanie z tej samej grupy już czeka na odpowiedź
+    for (const Subscriber &subscriber : std::as_const(job.subscribers)) {
+        if (subscriber.group == group && subscriber.request == request) {
+            return;
+        }
+    }
+    job.subscribers.append({request, group});
+}
+
+bool RequestScheduler::removeSubscribers(Job &job, const QString &group) {
+    job.subscribers.removeIf([&group](const Subscriber &subscriber) {
+        return subscriber.group == group;
+    });
+    return job.subscribers.isEmpty();
+}
+
+void RequestScheduler::onReplyFinished(QNetworkReply *reply) {
+    auto it = m_active.find(reply);
+
+    // Żądanie anulowane - nikt już nie czeka na odpowiedź
+    if (it == m_active.end()) {
+        reply->deleteLater();
+        return;
+    }
+
+    m_activePerHost[it.value().host]--;
+    countCacheResult(it.value(), reply);
+
+    QList<QNetworkRequest> requests;
+    requests.reserve(it.value().subscribers.size());
+    for (const Subscriber &subscriber : std::as_const(it.value().subscribers)) {
+        requests.append(subscriber.request);
+    }
+    m_active.erase(it);
+
+    emit replyFinished(reply, requests);
+
+    dispatch();
+    emit statsChanged();
+}
@@ -0,0 +1,133 @@
+#ifndef REQUESTSCHEDULER_H
+#define REQUESTSCHEDULER_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+
+// Kolejka żądań HTTP z priorytetami i limitem równoległych połączeń na host.
+// Stoi przed QNetworkAccessManager - żądania ekranu, który widzi użytkownik,
+// zawsze wychodzą przed pobieraniem w tle. Żądanie o adresie, który jest już
+// w kolejce lub w toku, dołącza do tamtego - odpowiedź jest pobierana raz.
+class RequestScheduler : public QObject {
+    Q_OBJECT
+    // Liczba żądań oczekujących w kolejce
+    Q_PROPERTY(int queueDepth READ queueDepth NOTIFY statsChanged)
+    // Liczba żądań w toku
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY statsChanged)
+    // Średni i maksymalny czas oczekiwania w kolejce (ms)
+    Q_PROPERTY(double averageWaitMs READ averageWaitMs NOTIFY statsChanged)
+    Q_PROPERTY(qint64 maxWaitMs READ maxWaitMs NOTIFY statsChanged)
+    // Odpowiedzi z pamięci podręcznej menedżera sieci: podane bez połączenia,
+    // pobrane z serwera i potwierdzone przez serwer jako aktualne (304)
+    Q_PROPERTY(int cacheHits READ cacheHits NOTIFY statsChanged)
+    Q_PROPERTY(int cacheMisses READ cacheMisses NOTIFY statsChanged)
+    Q_PROPERTY(int cacheRevalidations READ cacheRevalidations NOTIFY statsChanged)
+    // Liczba żądań dołączonych do innego żądania o tym samym adresie
+    Q_PROPERTY(int coalescedCount READ coalescedCount NOTIFY statsChanged)
+
+public:
+    // Klasy priorytetów - niższa wartość oznacza wyższy priorytet
+    enum Priority {
+        Interactive = 0,  // dane dla aktualnie widocznego ekranu
+        Normal = 1,       // dane potrzebne wkrótce
+        Background = 2    // pobieranie z wyprzedzeniem
+    };
+    Q_ENUM(Priority)
+
+    explicit RequestScheduler(QNetworkAccessManager *manager, QObject *parent = nullptr);
+
+    // Dodaje żądanie GET do kolejki i zwraca jego numer. Jeśli ten sam adres
+    // jest już w kolejce lub w toku, żądanie dołącza do niego (i zwraca jego numer);
+    // pilniejszy priorytet przenosi oczekujące żądanie do wyższej kolejki.
+    quint64 enqueue(const QNetworkRequest &request, Priority priority = Normal, const QString &group = QString());
+    // Anuluje wszystkie żądania z grupy - oczekujące i w toku. Pobieranie,
+    // na które czekają też inne grupy, trwa dalej.
+    void cancelGroup(const QString &group);
+
+    // Limit równoległych żądań do jednego hosta
+    int maxConcurrentPerHost() const { return m_maxConcurrentPerHost; }
+    void setMaxConcurrentPerHost(int max);
+
+    // Statystyki do strojenia kolejki
+    int queueDepth() const;
+    int activeCount() const { return m_active.size(); }
+    double averageWaitMs() const;
+    qint64 maxWaitMs() const { return m_maxWaitMs; }
+    int cacheHits() const { return m_cacheHits; }
+    int cacheMisses() const { return m_cacheMisses; }
+    int cacheRevalidations() const { return m_cacheRevalidations; }
+    int coalescedCount() const { return m_coalescedCount; }
+    void resetStats();
+
+signals:
+    // Żądanie wyszło do sieci - pozwala czytać treść w trakcie pobierania (readyRead).
+    // request to żądanie, które rozpoczęło pobieranie.
+    void replyStarted(QNetworkReply *reply, const QNetworkRequest &request);
+    // Odpowiedź na żądanie z kolejki; odbiorca odpowiada za deleteLater().
+    // requests - wszystkie żądania obsłużone tą odpowiedzią, w kolejności dodania.
+    void replyFinished(QNetworkReply *reply, const QList<QNetworkRequest> &requests);
+    void statsChanged();
+
+private:
+    // Stan wpisu w pamięci podręcznej w chwili wysłania żądania
+    enum CacheLookup {
+        NotCached,
+        CachedFresh,
+        CachedStale
+    };
+
+    // Żądanie czekające na odpowiedź wspólnego pobierania
+    struct Subscriber {
+        QNetworkRequest request;
+        QString group;
+    };
+
+    struct Job {
+        quint64 id = 0;
+        QNetworkRequest request;           // Wysyłane żądanie (pierwszego subskrybenta)
+        Priority priority = Normal;
+        QList<Subscriber> subscribers;
+        QString host;
+        QElapsedTimer queuedTimer;
+        CacheLookup cacheLookup = NotCached;
+    };
+
+    static constexpr int PriorityCount = 3;
+
+    void dispatch();
+    void start(Job job);
+    void onReplyFinished(QNetworkReply *reply);
+    // Sprawdza wpis żądania w pamięci podręcznej; świeży wpis zostanie podany bez sieci
+    CacheLookup lookupCache(QNetworkRequest &request) const;
+    void countCacheResult(const Job &job, QNetworkReply *reply);
+    // Dołącza żądanie do oczekującego lub trwającego pobierania tego samego adresu
+    bool attach(const QNetworkRequest &request, Priority priority, const QString &group, quint64 *id);
+    static void addSubscriber(Job &job, const QNetworkRequest &request, const QString &group);
+    // Usuwa subskrybentów z grupy; true, jeśli na pobieranie nikt już nie czeka
+    static bool removeSubscribers(Job &job, const QString &group);
+
+    QNetworkAccessManager *m_manager;
+    QList<Job> m_queues[PriorityCount];   // Kolejki FIFO dla każdego priorytetu
+    QHash<QNetworkReply *, Job> m_active;  // Żądania w toku
+    QHash<QString, int> m_activePerHost;   // Liczba żądań w toku na host
+    int m_maxConcurrentPerHost;
+    quint64 m_nextId;
+
+    // Statystyki czasu oczekiwania
+    qint64 m_totalWaitMs;
+    qint64 m_maxWaitMs;
+    qint64 m_startedCount;
+
+    // Statystyki pamięci podręcznej
+    int m_cacheHits;
+    int m_cacheMisses;
+    int m_cacheRevalidations;
+    int m_coalescedCount;
+};
+
+#endif // REQUESTSCHEDULER_H
@@ -0,0 +1,67 @@
+#include "responsecache.h"
+#include <QDateTime>
+#include <QStandardPaths>
+
+static const qint64 DefaultMaximumCacheSize = 20 * 1024 * 1024;
+
+// Czasy ważności dla rodzajów zapytań. Pomiary i indeks jakości powietrza
+// zmieniają się co godzinę, lista czujników i katalog stacji - rzadko.
+struct EndpointTtl {
+    const char *path;
+    qint64 ttlMs;
+};
+
+static const EndpointTtl EndpointTtls[] = {
+    {"/pjp-api/rest/station/findAll", 6 * 60 * 60 * 1000},
+    {"/pjp-api/rest/station/sensors/", 6 * 60 * 60 * 1000},
+    {"/pjp-api/rest/data/getData/", 15 * 60 * 1000},
+    {"/pjp-api/rest/aqindex/getIndex/", 15 * 60 * 1000}
+};
+
+ResponseCache::ResponseCache(QObject *parent)
+    : QNetworkDiskCache(parent) {
+    setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/http");
+    setMaximumCacheSize(DefaultMaximumCacheSize);
+}
+
+qint64 ResponseCache::ttlFor(const QUrl &url) {
+    const QString path = url.path();
+    for (const EndpointTtl &endpoint : EndpointTtls) {
+        if (path.startsWith(QLatin1String(endpoint.path))) {
+            return endpoint.ttlMs;
+        }
+    }
+    return 0;
+}
+
+bool ResponseCache::isFresh(const QNetworkCacheMetaData &metaData) {
+    return metaData.isValid() && metaData.expirationDate().isValid()
+           && QDateTime::currentDateTimeUtc() < metaData.expirationDate();
+}
+
+QIODevice *ResponseCache::prepare(const QNetworkCacheMetaData &metaData) {
+    return QNetworkDiskCache::prepare(withPolicy(metaData));
+}
+
+void ResponseCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+    // Odpowiedź 304 - treść jest aktualna, więc wpis znów jest świeży
+    QNetworkDiskCache::updateMetaData(withPolicy(metaData));
+}
+
+QNetworkCacheMetaData ResponseCache::withPolicy(const QNetworkCacheMetaData &metaData) {
+    QNetworkCacheMetaData result = metaData;
+    result.setSaveToDisk(true);
+    result.setExpirationDate(QDateTime::currentDateTimeUtc().addMSecs(ttlFor(metaData.url())));
+
+    // Nagłówki sterujące pamięcią podręczną zastępuje nasz czas ważności;
+    // ETag i Last-Modified zostają do zapytań warunkowych
+    QNetworkCacheMetaData::RawHeaderList headers = result.rawHeaders();
+    headers.removeIf([](const QNetworkCacheMetaData::RawHeader &header) {
+        return header.first.compare("Cache-Control", Qt::CaseInsensitive) == 0
+               || header.first.compare("Pragma", Qt::CaseInsensitive) == 0
+               || header.first.compare("Expires", Qt::CaseInsensitive) == 0;
+    });
+    result.setRawHeaders(headers);
+
+    return result;
+}
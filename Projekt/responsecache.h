@@ -0,0 +1,32 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QNetworkDiskCache>
+#include <QUrl>
+
+// Dyskowa pamięć podręczna odpowiedzi API GIOŚ (ustawiana w QNetworkAccessManager).
+// Czas ważności wpisu wynika z rodzaju zapytania (ttlFor), a nie z nagłówków
+// serwera. Świeży wpis jest podawany bez połączenia; nieaktualny jest sprawdzany
+// warunkowo (If-None-Match / If-Modified-Since, jeśli serwer podał ETag lub
+// Last-Modified) i przy odpowiedzi 304 treść pochodzi z dysku.
+class ResponseCache : public QNetworkDiskCache {
+    Q_OBJECT
+
+public:
+    // Domyślnie wpisy leżą w CacheLocation/http i zajmują najwyżej 20 MB
+    explicit ResponseCache(QObject *parent = nullptr);
+
+    // Czas ważności odpowiedzi dla adresu (ms); 0 - zawsze sprawdzana na serwerze
+    static qint64 ttlFor(const QUrl &url);
+    // Czy wpis można podać bez pytania serwera
+    static bool isFresh(const QNetworkCacheMetaData &metaData);
+
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+
+private:
+    // Opis wpisu z czasem ważności według ttlFor() zamiast nagłówków serwera
+    static QNetworkCacheMetaData withPolicy(const QNetworkCacheMetaData &metaData);
+};
+
+#endif // RESPONSECACHE_H
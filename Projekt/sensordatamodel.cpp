@@ -0,0 +1,167 @@
+#include "sensordatamodel.h"
+#include <QSet>
+
+SensorDataModel::SensorDataModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+int SensorDataModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_readings.size();
+}
+
+QVariant SensorDataModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_readings.size()) {
+        return QVariant();
+    }
+
+    const SensorReading &reading = m_readings[index.row()];
+    switch (role) {
+    case SensorIdRole:
+        return reading.sensorId;
+    case Qt::DisplayRole:
+    case ParamRole:
+        return reading.param;
+    case ParamCodeRole:
+        return reading.paramCode;
+    case ParamFormulaRole:
+        return reading.paramFormula;
+    case ValueRole:
+        return reading.value;
+    case DateRole:
+        return reading.date;
+    case UnitRole:
+        return reading.unit;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SensorDataModel::roleNames() const {
+    return {
+        {SensorIdRole, "sensorId"},
+        {ParamRole, "param"},
+        {ParamCodeRole, "paramCode"},
+        {ParamFormulaRole, "paramFormula"},
+        {ValueRole, "value"},
+        {DateRole, "date"},
+        {UnitRole, "unit"}
+    };
+}
+
+int SensorDataModel::rowOf(int sensorId) const {
+    for (int row = 0; row < m_readings.size(); ++row) {
+        if (m_readings[row].sensorId == sensorId) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+void SensorDataModel::upsert(const SensorReading &reading) {
+    const int row = rowOf(reading.sensorId);
+
+    // Nowy czujnik - wstawiamy jeden wiersz, zachowując kolejność czujników stacji
+    if (row < 0) {
+        int insertRow = m_readings.size();
+        while (insertRow > 0 && m_readings[insertRow - 1].position > reading.position) {
+            --insertRow;
+        }
+
+        beginInsertRows(QModelIndex(), insertRow, insertRow);
+        m_readings.insert(insertRow, reading);
+        endInsertRows();
+        emit countChanged();
+        return;
+    }
+
+    // Istniejący czujnik - powiadamiamy tylko o zmienionym wierszu
+    const SensorReading &current = m_readings[row];
+    if (current.value == reading.value && current.date == reading.date && current.unit == reading.unit
+        && current.param == reading.param && current.paramCode == reading.paramCode
+        && current.paramFormula == reading.paramFormula && current.position == reading.position) {
+        return;
+    }
+
+    // Zmieniona kolejność na liście stacji (np. wiersze z przywróconej sesji) -
+    // przenosimy wiersz w nowe miejsce według tej samej reguły co przy wstawianiu
+    int targetRow = row;
+    if (current.position != reading.position) {
+        targetRow = m_readings.size() - 1;
+        while (targetRow > 0) {
+            const int otherRow = targetRow > row ? targetRow : targetRow - 1;
+            if (m_readings[otherRow].position <= reading.position) {
+                break;
+            }
+            --targetRow;
+        }
+    }
+
+    if (targetRow != row) {
+        // destinationChild liczony jest według wierszy sprzed przeniesienia
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), targetRow > row ? targetRow + 1 : targetRow);
+        m_readings.move(row, targetRow);
+        endMoveRows();
+    }
+
+    m_readings[targetRow] = reading;
+    const QModelIndex changed = index(targetRow);
+    emit dataChanged(changed, changed);
+}
+
+void SensorDataModel::setReadings(const QList<SensorReading> &readings) {
+    QSet<int> newIds;
+    newIds.reserve(readings.size());
+    for (const SensorReading &reading : readings) {
+        newIds.insert(reading.sensorId);
+    }
+
+    // Usuwamy czujniki, których nie ma na nowej liście
+    bool removed = false;
+    for (int row = m_readings.size() - 1; row >= 0; --row) {
+        if (!newIds.contains(m_readings[row].sensorId)) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_readings.removeAt(row);
+            endRemoveRows();
+            removed = true;
+        }
+    }
+    if (removed) {
+        emit countChanged();
+    }
+
+    for (const SensorReading &reading : readings) {
+        upsert(reading);
+    }
+}
+
+void SensorDataModel::clear() {
+    if (m_readings.isEmpty()) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), 0, m_readings.size() - 1);
+    m_readings.clear();
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+QVariantMap SensorDataModel::get(int row) const {
+    QVariantMap result;
+    if (row < 0 || row >= m_readings.size()) {
+        return result;
+    }
+
+    const SensorReading &reading = m_readings[row];
+    result["sensorId"] = reading.sensorId;
+    result["param"] = reading.param;
+    result["paramCode"] = reading.paramCode;
+    result["paramFormula"] = reading.paramFormula;
+    result["value"] = reading.value;
+    result["date"] = reading.date;
+    result["unit"] = reading.unit;
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef SENSORDATAMODEL_H
+#define SENSORDATAMODEL_H
+
+#include <QAbstractListModel>
+
+// Czujnik stacji wraz z ostatnim pomiarem
+struct SensorReading {
+    int sensorId = 0;
+    int position = 0;  // Kolejność czujnika na liście stacji
+    QString param;
+    QString paramCode;
+    QString paramFormula;
+    double value = 0.0;
+    QString date;
+    QString unit;
+};
+
+// Ostatnie pomiary czujników wybranej stacji udostępniane w QML.
+// Wiersze są dodawane i aktualizowane pojedynczo.
+class SensorDataModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        SensorIdRole = Qt::UserRole + 1,
+        ParamRole,
+        ParamCodeRole,
+        ParamFormulaRole,
+        ValueRole,
+        DateRole,
+        UnitRole
+    };
+
+    explicit SensorDataModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Dodaje czujnik (w miejscu wynikającym z position) lub aktualizuje istniejący wiersz,
+    // przenosząc go, gdy zmieniła się jego pozycja
+    void upsert(const SensorReading &reading);
+    // Ustawia pełną listę: usuwa brakujące czujniki, resztę nanosi przez upsert()
+    void setReadings(const QList<SensorReading> &readings);
+    void clear();
+
+    const QList<SensorReading> &readings() const { return m_readings; }
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+signals:
+    void countChanged();
+
+private:
+    int rowOf(int sensorId) const;
+
+    QList<SensorReading> m_readings;
+};
+
+#endif // SENSORDATAMODEL_H
@@ -0,0 +1,210 @@
+#include "sensorhistorymodel.h"
+#include "giosdate.h"
+#include <algorithm>
+
+SensorHistoryModel::SensorHistoryModel(QObject *parent)
+    : QAbstractListModel(parent),
+    m_rangeStart(0),
+    m_rangeEnd(0),
+    m_rangeFirst(0),
+    m_rangeLast(0),
+    m_rangeFirstTimestamp(0),
+    m_rangeLastTimestamp(0),
+    m_rangeMedian(0.0),
+    m_rangeP90(0.0),
+    m_rangeP95(0.0) {
+}
+
+int SensorHistoryModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_series.size();
+}
+
+QVariant SensorHistoryModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_series.size()) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole:
+    case ValueRole:
+        return double(m_series.valueAt(row));
+    case TimestampRole:
+        return m_series.timestampAt(row);
+    case DateRole:
+        // Tekst daty tworzymy dopiero na żądanie - nie jest przechowywany
+        return GiosDate::format(m_series.timestampAt(row));
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SensorHistoryModel::roleNames() const {
+    return {
+        {ValueRole, "value"},
+        {TimestampRole, "timestamp"},
+        {DateRole, "date"}
+    };
+}
+
+void SensorHistoryModel::setSeries(const TimeSeries &series) {
+    const bool infoChanged = m_series.info().sensorId != series.info().sensorId
+                             || m_series.info().unit != series.info().unit;
+
+    // Ten sam czujnik: sprawdzamy, czy wspólna część obu serii ma te same
+    // znaczniki czasu - wtedy nanosimy tylko różnice
+    const int dropFront = m_series.isEmpty() || series.isEmpty() ? 0 : m_series.lowerBound(series.firstTimestamp());
+    const int overlap = m_series.size() - dropFront;
+    const bool incremental = !infoChanged && !m_series.isEmpty() && !series.isEmpty()
+                             && overlap <= series.size()
+                             && std::equal(m_series.timestamps().cbegin() + dropFront, m_series.timestamps().cend(),
+                                           series.timestamps().cbegin());
+
+    if (!incremental) {
+        beginResetModel();
+        m_series = series;
+        endResetModel();
+
+        emit countChanged();
+        if (infoChanged) {
+            emit seriesInfoChanged();
+        }
+        updateRangeStats();
+        return;
+    }
+
+    const int oldCount = m_series.size();
+    m_series.info() = series.info();
+
+    // Najstarsze punkty, których nie ma już w nowej serii
+    if (dropFront > 0) {
+        beginRemoveRows(QModelIndex(), 0, dropFront - 1);
+        m_series.removeFirst(dropFront);
+        endRemoveRows();
+    }
+
+    // Zmienione wartości we wspólnej części
+    int firstChanged = -1;
+    int lastChanged = -1;
+    for (int row = 0; row < overlap; ++row) {
+        if (m_series.valueAt(row) != series.valueAt(row)) {
+            m_series.setValueAt(row, series.valueAt(row));
+            if (firstChanged < 0) {
+                firstChanged = row;
+            }
+            lastChanged = row;
+        }
+    }
+    if (firstChanged >= 0) {
+        emit dataChanged(index(firstChanged), index(lastChanged));
+    }
+
+    // Nowe pomiary na końcu
+    if (series.size() > overlap) {
+        beginInsertRows(QModelIndex(), overlap, series.size() - 1);
+        for (int row = overlap; row < series.size(); ++row) {
+            m_series.append(series.timestampAt(row), series.valueAt(row));
+        }
+        endInsertRows();
+    }
+
+    if (m_series.size() != oldCount || dropFront > 0) {
+        emit countChanged();
+    }
+    updateRangeStats();
+}
+
+void SensorHistoryModel::clear() {
+    if (m_series.isEmpty()) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), 0, m_series.size() - 1);
+    m_series.clear();
+    endRemoveRows();
+
+    emit countChanged();
+    updateRangeStats();
+}
+
+qint64 SensorHistoryModel::timestampAt(int row) const {
+    if (row < 0 || row >= m_series.size()) {
+        return 0;
+    }
+    return m_series.timestampAt(row);
+}
+
+double SensorHistoryModel::valueAt(int row) const {
+    if (row < 0 || row >= m_series.size()) {
+        return 0.0;
+    }
+    return m_series.valueAt(row);
+}
+
+void SensorHistoryModel::setRange(qint64 start, qint64 end) {
+    if (m_rangeStart == start && m_rangeEnd == end) {
+        return;
+    }
+
+    m_rangeStart = start;
+    m_rangeEnd = end;
+    emit rangeChanged();
+    updateRangeStats();
+}
+
+void SensorHistoryModel::updateRangeStats() {
+    m_rangeFirst = m_rangeStart > 0 ? m_series.lowerBound(m_rangeStart) : 0;
+    m_rangeLast = m_rangeEnd > 0 ? m_series.upperBound(m_rangeEnd) : m_series.size();
+    m_rangeLast = qMax(m_rangeFirst, m_rangeLast);
+    updateRangeInfo();
+
+    m_rangeStats = m_series.stats(m_rangeFirst, m_rangeLast);
+    m_rangeMedian = m_series.percentile(m_rangeFirst, m_rangeLast, 50.0, m_scratch);
+    m_rangeP90 = m_series.percentile(m_rangeFirst, m_rangeLast, 90.0, m_scratch);
+    m_rangeP95 = m_series.percentile(m_rangeFirst, m_rangeLast, 95.0, m_scratch);
+
+    emit rangeStatsChanged();
+}
+
+void SensorHistoryModel::updateRangeInfo() {
+    const int count = m_rangeLast - m_rangeFirst;
+    const qint64 firstTimestamp = count > 0 ? m_series.timestampAt(m_rangeFirst) : 0;
+    const qint64 lastTimestamp = count > 0 ? m_series.timestampAt(m_rangeLast - 1) : 0;
+
+    // Opis formatujemy tylko wtedy, gdy zakres faktycznie się zmienił
+    // (m_rangeStats zawiera jeszcze liczbę punktów poprzedniego zakresu)
+    if (firstTimestamp == m_rangeFirstTimestamp && lastTimestamp == m_rangeLastTimestamp
+        && count == m_rangeStats.count) {
+        return;
+    }
+
+    m_rangeFirstTimestamp = firstTimestamp;
+    m_rangeLastTimestamp = lastTimestamp;
+
+    // Daty jako YYYY-MM-DD (czas polski)
+    if (count > 0) {
+        m_rangeLabel = QStringLiteral("Wyświetlanie %1 pomiarów z okresu %2 - %3")
+                           .arg(count)
+                           .arg(GiosDate::format(firstTimestamp).left(10),
+                                GiosDate::format(lastTimestamp).left(10));
+    } else {
+        m_rangeLabel.clear();
+    }
+
+    emit rangeInfoChanged();
+}
+
+qint64 SensorHistoryModel::rangeMinTimestamp() const {
+    return m_rangeStats.argMin >= 0 ? m_series.timestampAt(m_rangeStats.argMin) : 0;
+}
+
+qint64 SensorHistoryModel::rangeMaxTimestamp() const {
+    return m_rangeStats.argMax >= 0 ? m_series.timestampAt(m_rangeStats.argMax) : 0;
+}
+
+double SensorHistoryModel::rangePercentile(double p) const {
+    return m_series.percentile(m_rangeFirst, m_rangeLast, p, m_scratch);
+}
@@ -0,0 +1,123 @@
+#ifndef SENSORHISTORYMODEL_H
+#define SENSORHISTORYMODEL_H
+
+#include <QAbstractListModel>
+
+#include "timeseries.h"
+
+// Historia pomiarów wybranego czujnika (od najstarszych do najnowszych).
+// Dane są trzymane kolumnowo w TimeSeries; QML może czytać je przez role
+// albo bezpośrednio przez timestampAt()/valueAt().
+class SensorHistoryModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    // Znaczniki czasu najstarszego i najnowszego pomiaru (ms od epoki)
+    Q_PROPERTY(qint64 firstTimestamp READ firstTimestamp NOTIFY countChanged)
+    Q_PROPERTY(qint64 lastTimestamp READ lastTimestamp NOTIFY countChanged)
+    // Jednostka miary serii
+    Q_PROPERTY(QString unit READ unit NOTIFY seriesInfoChanged)
+
+    // Wybrany zakres czasu (ms od epoki); 0 oznacza brak ograniczenia z danej strony
+    Q_PROPERTY(qint64 rangeStart READ rangeStart NOTIFY rangeChanged)
+    Q_PROPERTY(qint64 rangeEnd READ rangeEnd NOTIFY rangeChanged)
+    // Indeksy punktów w zakresie: [rangeFirstIndex, rangeLastIndex)
+    Q_PROPERTY(int rangeFirstIndex READ rangeFirstIndex NOTIFY rangeStatsChanged)
+    Q_PROPERTY(int rangeLastIndex READ rangeLastIndex NOTIFY rangeStatsChanged)
+    // Pierwszy i ostatni pomiar w zakresie oraz gotowy opis zakresu do nagłówka
+    Q_PROPERTY(qint64 rangeFirstTimestamp READ rangeFirstTimestamp NOTIFY rangeInfoChanged)
+    Q_PROPERTY(qint64 rangeLastTimestamp READ rangeLastTimestamp NOTIFY rangeInfoChanged)
+    Q_PROPERTY(QString rangeLabel READ rangeLabel NOTIFY rangeInfoChanged)
+    // Statystyki punktów w zakresie, przeliczane przy zmianie danych lub zakresu
+    Q_PROPERTY(int rangeCount READ rangeCount NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeMin READ rangeMin NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeMax READ rangeMax NOTIFY rangeStatsChanged)
+    Q_PROPERTY(qint64 rangeMinTimestamp READ rangeMinTimestamp NOTIFY rangeStatsChanged)
+    Q_PROPERTY(qint64 rangeMaxTimestamp READ rangeMaxTimestamp NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeMean READ rangeMean NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeStdDev READ rangeStdDev NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeMedian READ rangeMedian NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeP90 READ rangeP90 NOTIFY rangeStatsChanged)
+    Q_PROPERTY(double rangeP95 READ rangeP95 NOTIFY rangeStatsChanged)
+
+public:
+    enum Roles {
+        ValueRole = Qt::UserRole + 1,
+        TimestampRole,
+        DateRole
+    };
+
+    explicit SensorHistoryModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Ustawia historię. Dla tego samego czujnika nanoszone są tylko różnice:
+    // usunięte najstarsze punkty, zmienione wartości i nowe pomiary na końcu
+    void setSeries(const TimeSeries &series);
+    void clear();
+
+    const TimeSeries &series() const { return m_series; }
+    qint64 firstTimestamp() const { return m_series.firstTimestamp(); }
+    qint64 lastTimestamp() const { return m_series.lastTimestamp(); }
+    QString unit() const { return m_series.info().unit; }
+
+    Q_INVOKABLE qint64 timestampAt(int row) const;
+    Q_INVOKABLE double valueAt(int row) const;
+
+    qint64 rangeStart() const { return m_rangeStart; }
+    qint64 rangeEnd() const { return m_rangeEnd; }
+    // Ustawia zakres czasu; punkty są wyszukiwane binarnie w posortowanej serii
+    Q_INVOKABLE void setRange(qint64 start, qint64 end);
+
+    int rangeFirstIndex() const { return m_rangeFirst; }
+    int rangeLastIndex() const { return m_rangeLast; }
+
+    qint64 rangeFirstTimestamp() const { return m_rangeFirstTimestamp; }
+    qint64 rangeLastTimestamp() const { return m_rangeLastTimestamp; }
+    QString rangeLabel() const { return m_rangeLabel; }
+
+    int rangeCount() const { return m_rangeStats.count; }
+    double rangeMin() const { return m_rangeStats.min; }
+    double rangeMax() const { return m_rangeStats.max; }
+    qint64 rangeMinTimestamp() const;
+    qint64 rangeMaxTimestamp() const;
+    double rangeMean() const { return m_rangeStats.mean; }
+    double rangeStdDev() const { return m_rangeStats.stdDev; }
+    double rangeMedian() const { return m_rangeMedian; }
+    double rangeP90() const { return m_rangeP90; }
+    double rangeP95() const { return m_rangeP95; }
+    // Dowolny percentyl (0-100) wartości w zakresie
+    Q_INVOKABLE double rangePercentile(double p) const;
+
+signals:
+    void countChanged();
+    void seriesInfoChanged();
+    void rangeChanged();
+    void rangeStatsChanged();
+    void rangeInfoChanged();
+
+private:
+    // Wyznacza indeksy zakresu i przelicza statystyki
+    void updateRangeStats();
+    // Aktualizuje opis zakresu, o ile zmienił się jego początek, koniec lub liczba punktów
+    void updateRangeInfo();
+
+    TimeSeries m_series;
+
+    qint64 m_rangeStart;
+    qint64 m_rangeEnd;
+    int m_rangeFirst;
+    int m_rangeLast;
+    qint64 m_rangeFirstTimestamp;
+    qint64 m_rangeLastTimestamp;
+    QString m_rangeLabel;
+    RangeStats m_rangeStats;
+    double m_rangeMedian;
+    double m_rangeP90;
+    double m_rangeP95;
+    // Bufor roboczy dla percentyli
+    mutable QList<float> m_scratch;
+};
+
+#endif // SENSORHISTORYMODEL_H
@@ -0,0 +1,273 @@
+#include "seriescodec.h"
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+inline quint64 lowBits(int bits) {
+    return bits >= 64 ? ~quint64(0) : (quint64(1) << bits) - 1;
+}
+
+// Zapis bitów od najstarszego; pełne bajty trafiają od razu do bufora
+class BitWriter {
+public:
+    explicit BitWriter(QByteArray &bytes) : m_bytes(bytes), m_buffer(0), m_count(0) {}
+
+    // bits <= 32
+    void write(quint64 value, int bits) {
+        m_buffer = (m_buffer << bits) | (value & lowBits(bits));
+        m_count += bits;
+        while (m_count >= 8) {
+            m_count -= 8;
+            m_bytes.append(char(m_buffer >> m_count));
+        }
+    }
+
+    void write64(quint64 value) {
+        write(value >> 32, 32);
+        write(value, 32);
+    }
+
+    // Dopełnia ostatni bajt zerami
+    void flush() {
+        if (m_count > 0) {
+            write(0, 8 - m_count);
+        }
+    }
+
+private:
+    QByteArray &m_bytes;
+    quint64 m_buffer;
+    int m_count;
+};
+
+class BitReader {
+public:
+    BitReader(const uchar *data, qsizetype size) : m_data(data), m_end(data + size), m_buffer(0), m_count(0), m_overrun(false) {}
+
+    // bits <= 32
+    quint64 read(int bits) {
+        while (m_count < bits) {
+            if (m_data < m_end) {
+                m_buffer = (m_buffer << 8) | *m_data++;
+            } else {
+                m_buffer <<= 8;
+                m_overrun = true;
+            }
+            m_count += 8;
+        }
+        m_count -= bits;
+        return (m_buffer >> m_count) & lowBits(bits);
+    }
+
+    quint64 read64() {
+        const quint64 high = read(32);
+        return (high << 32) | read(32);
+    }
+
+    bool overrun() const { return m_overrun; }
+
+private:
+    const uchar *m_data;
+    const uchar *m_end;
+    quint64 m_buffer;
+    int m_count;
+    bool m_overrun;
+};
+
+// Rozszerzenie znaku liczby zapisanej na bits bitach
+inline qint64 signExtend(quint64 value, int bits) {
+    const quint64 sign = quint64(1) << (bits - 1);
+    return qint64((value ^ sign) - sign);
+}
+
+inline quint32 floatBits(float value) {
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(quint32 bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Kody różnicy różnic: prefiks i liczba bitów wartości ze znakiem
+struct DeltaClass {
+    quint64 prefix;
+    int prefixBits;
+    int valueBits;
+};
+
+const DeltaClass DeltaClasses[] = {
+    {0b10, 2, 7},
+    {0b110, 3, 9},
+    {0b1110, 4, 12},
+    {0b11110, 5, 32}
+};
+// Pozostałe różnice: prefiks 11111 i pełne 64 bity
+const quint64 FullDeltaPrefix = 0b11111;
+const int FullDeltaPrefixBits = 5;
+
+void writeDeltaOfDelta(BitWriter &writer, qint64 delta) {
+    if (delta == 0) {
+        writer.write(0, 1);
+        return;
+    }
+
+    for (const DeltaClass &deltaClass : DeltaClasses) {
+        const qint64 limit = qint64(1) << (deltaClass.valueBits - 1);
+        if (delta >= -limit && delta < limit) {
+            writer.write(deltaClass.prefix, deltaClass.prefixBits);
+            writer.write(quint64(delta), deltaClass.valueBits);
+            return;
+        }
+    }
+
+    writer.write(FullDeltaPrefix, FullDeltaPrefixBits);
+    writer.write64(quint64(delta));
+}
+
+qint64 readDeltaOfDelta(BitReader &reader) {
+    if (reader.read(1) == 0) {
+        return 0;
+    }
+
+    // Liczba jedynek w prefiksie wyznacza klasę
+    int ones = 1;
+    while (ones < FullDeltaPrefixBits && reader.read(1) == 1) {
+        ++ones;
+    }
+
+    if (ones == FullDeltaPrefixBits) {
+        return qint64(reader.read64());
+    }
+    const int valueBits = DeltaClasses[ones - 1].valueBits;
+    return signExtend(reader.read(valueBits), valueBits);
+}
+
+} // namespace
+
+namespace SeriesCodec {
+
+QByteArray encode(const TimeSeries &series) {
+    QByteArray bytes;
+    const int count = series.size();
+    // Typowo kilka bitów na punkt
+    bytes.reserve(4 + 16 + count * 2);
+
+    char header[4];
+    qToLittleEndian<quint32>(quint32(count), header);
+    bytes.append(header, sizeof(header));
+    if (count == 0) {
+        return bytes;
+    }
+
+    BitWriter writer(bytes);
+
+    // Pierwszy punkt zapisujemy w całości
+    qint64 previousTimestamp = series.timestampAt(0);
+    quint32 previousValue = floatBits(series.valueAt(0));
+    writer.write64(quint64(previousTimestamp));
+    writer.write(previousValue, 32);
+
+    qint64 previousDelta = 0;
+    int previousLeading = -1;
+    int previousTrailing = 0;
+
+    for (int i = 1; i < count; ++i) {
+        const qint64 timestamp = series.timestampAt(i);
+        const qint64 delta = timestamp - previousTimestamp;
+        writeDeltaOfDelta(writer, delta - previousDelta);
+        previousTimestamp = timestamp;
+        previousDelta = delta;
+
+        const quint32 value = floatBits(series.valueAt(i));
+        const quint32 xored = value ^ previousValue;
+        previousValue = value;
+
+        if (xored == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        // xored != 0, więc zer wiodących jest najwyżej 31 - mieszczą się w 5 bitach
+        const int leading = int(qCountLeadingZeroBits(xored));
+        const int trailing = int(qCountTrailingZeroBits(xored));
+
+        // Znaczące bity mieszczą się w poprzednim oknie - zapisujemy tylko je
+        if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+            const int meaningful = 32 - previousLeading - previousTrailing;
+            writer.write(0b10, 2);
+            writer.write(xored >> previousTrailing, meaningful);
+            continue;
+        }
+
+        // Nowe okno: 5 bitów zer wiodących, 5 bitów długości-1 i znaczące bity
+        const int meaningful = 32 - leading - trailing;
+        writer.write(0b11, 2);
+        writer.write(quint64(leading), 5);
+        writer.write(quint64(meaningful - 1), 5);
+        writer.write(xored >> trailing, meaningful);
+        previousLeading = leading;
+        previousTrailing = trailing;
+    }
+
+    writer.flush();
+    return bytes;
+}
+
+bool decode(const char *data, qsizetype size, TimeSeries &series) {
+    if (size < 4) {
+        return false;
+    }
+
+    const quint32 count = qFromLittleEndian<quint32>(data);
+    if (count == 0) {
+        return true;
+    }
+
+    // Pierwszy punkt zajmuje 96 bitów, każdy następny co najmniej 2 (bit różnicy
+    // i bit wartości). Liczba, której dane nie pomieszczą, oznacza uszkodzony
+    // nagłówek - sprawdzamy ją przed rezerwacją pamięci.
+    const qint64 minimumBits = 96 + 2 * (qint64(count) - 1);
+    if (minimumBits > qint64(size - 4) * 8) {
+        return false;
+    }
+
+    BitReader reader(reinterpret_cast<const uchar *>(data) + 4, size - 4);
+    series.reserve(series.size() + int(count));
+
+    qint64 timestamp = qint64(reader.read64());
+    quint32 value = quint32(reader.read(32));
+    series.append(timestamp, bitsFloat(value));
+
+    qint64 delta = 0;
+    int leading = 0;
+    int trailing = 0;
+
+    for (quint32 i = 1; i < count; ++i) {
+        delta += readDeltaOfDelta(reader);
+        timestamp += delta;
+
+        if (reader.read(1) == 1) {
+            if (reader.read(1) == 1) {
+                leading = int(reader.read(5));
+                trailing = 32 - leading - (int(reader.read(5)) + 1);
+                if (trailing < 0) {
+                    return false;
+                }
+            }
+            const int meaningful = 32 - leading - trailing;
+            value ^= quint32(reader.read(meaningful) << trailing);
+        }
+
+        series.append(timestamp, bitsFloat(value));
+    }
+
+    return !reader.overrun();
+}
+
+} // namespace SeriesCodec
@@ -0,0 +1,21 @@
+#ifndef SERIESCODEC_H
+#define SERIESCODEC_H
+
+#include <QByteArray>
+
+#include "timeseries.h"
+
+// Kompresja serii w stylu Gorilla (Facebook, 2015):
+//  - znaczniki czasu: różnica różnic kolejnych znaczników w krótkich kodach
+//    (dla pomiarów co godzinę najczęściej jeden bit na punkt),
+//  - wartości: XOR z poprzednią wartością float, zapisujemy tylko znaczące bity.
+// Format: liczba punktów (uint32 LE), potem strumień bitów (od najstarszego bitu).
+namespace SeriesCodec {
+
+QByteArray encode(const TimeSeries &series);
+// Dopisuje zdekodowane punkty do series; false przy uszkodzonych danych
+bool decode(const char *data, qsizetype size, TimeSeries &series);
+
+} // namespace SeriesCodec
+
+#endif // SERIESCODEC_H
@@ -0,0 +1,101 @@
+#include "sessionstore.h"
+#include <QSettings>
+#include <QStandardPaths>
+
+SessionStore::SessionStore()
+    : m_path(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/session.ini") {
+}
+
+SessionStore::SessionStore(const QString &path)
+    : m_path(path) {
+}
+
+SessionState SessionStore::load() const {
+    QSettings settings(m_path, QSettings::IniFormat);
+    SessionState state;
+
+    state.screen = settings.value("view/screen", 0).toInt();
+    state.cityName = settings.value("view/city").toString();
+
+    settings.beginGroup("station");
+    state.station.id = settings.value("id", 0).toInt();
+    state.station.name = settings.value("name").toString();
+    state.station.city = settings.value("city").toString();
+    state.station.lat = settings.value("lat").toString();
+    state.station.lon = settings.value("lon").toString();
+    state.station.address = settings.value("address").toString();
+    state.airQualityStatus = settings.value("airQuality").toString();
+    settings.endGroup();
+
+    const int count = settings.beginReadArray("readings");
+    state.readings.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        settings.setArrayIndex(i);
+        SensorReading reading;
+        reading.sensorId = settings.value("sensorId").toInt();
+        reading.position = settings.value("position").toInt();
+        reading.param = settings.value("param").toString();
+        reading.paramCode = settings.value("paramCode").toString();
+        reading.paramFormula = settings.value("paramFormula").toString();
+        reading.value = settings.value("value").toDouble();
+        reading.date = settings.value("date").toString();
+        reading.unit = settings.value("unit").toString();
+        state.readings.append(reading);
+    }
+    settings.endArray();
+
+    settings.beginGroup("sensor");
+    state.sensorId = settings.value("id", 0).toInt();
+    state.param = settings.value("param").toString();
+    state.paramFormula = settings.value("paramFormula").toString();
+    settings.endGroup();
+
+    // Ekran bez danych, których potrzebuje, nie ma czego pokazać
+    if (state.station.id <= 0) {
+        state.screen = 0;
+    } else if (state.screen == 2 && state.sensorId <= 0) {
+        state.screen = 1;
+    }
+
+    return state;
+}
+
+void SessionStore::save(const SessionState &state) const {
+    QSettings settings(m_path, QSettings::IniFormat);
+
+    settings.setValue("view/screen", state.screen);
+    settings.setValue("view/city", state.cityName);
+
+    settings.beginGroup("station");
+    settings.setValue("id", state.station.id);
+    settings.setValue("name", state.station.name);
+    settings.setValue("city", state.station.city);
+    settings.setValue("lat", state.station.lat);
+    settings.setValue("lon", state.station.lon);
+    settings.setValue("address", state.station.address);
+    settings.setValue("airQuality", state.airQualityStatus);
+    settings.endGroup();
+
+    // Tablica jest zapisywana od nowa - usuwamy też wpisy poprzedniej stacji
+    settings.remove("readings");
+    settings.beginWriteArray("readings", state.readings.size());
+    for (int i = 0; i < state.readings.size(); ++i) {
+        const SensorReading &reading = state.readings.at(i);
+        settings.setArrayIndex(i);
+        settings.setValue("sensorId", reading.sensorId);
+        settings.setValue("position", reading.position);
+        settings.setValue("param", reading.param);
+        settings.setValue("paramCode", reading.paramCode);
+        settings.setValue("paramFormula", reading.paramFormula);
+        settings.setValue("value", reading.value);
+        settings.setValue("date", reading.date);
+        settings.setValue("unit", reading.unit);
+    }
+    settings.endArray();
+
+    settings.beginGroup("sensor");
+    settings.setValue("id", state.sensorId);
+    settings.setValue("param", state.param);
+    settings.setValue("paramFormula", state.paramFormula);
+    settings.endGroup();
+}
@@ -0,0 +1,39 @@
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QString>
+#include <QList>
+
+#include "stationcatalog.h"
+#include "sensordatamodel.h"
+
+// Ostatni stan widoku wraz z danymi potrzebnymi, by go od razu odtworzyć
+struct SessionState {
+    int screen = 0;     // 0 - lista stacji, 1 - szczegóły stacji, 2 - historia pomiarów
+    QString cityName;
+    StationRecord station;                // Wybrana stacja (id 0 - brak)
+    QList<SensorReading> readings;        // Ostatnie pomiary czujników stacji
+    QString airQualityStatus;
+    int sensorId = 0;                     // Czujnik, którego historia jest wyświetlana
+    QString param;
+    QString paramFormula;
+};
+
+// Zapis stanu sesji w pliku INI (QSettings) w AppLocalDataLocation.
+// Historia czujników leży w HistoryStore, a katalog stacji w migawce katalogu,
+// więc tutaj trafia tylko to, czego nie ma w żadnym z nich.
+class SessionStore {
+public:
+    SessionStore();
+    explicit SessionStore(const QString &path);
+
+    QString path() const { return m_path; }
+
+    SessionState load() const;
+    void save(const SessionState &state) const;
+
+private:
+    QString m_path;
+};
+
+#endif // SESSIONSTORE_H
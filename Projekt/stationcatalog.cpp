@@ -0,0 +1,80 @@
+#include "stationcatalog.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+
+// Katalog stacji zmienia się rzadko - po 6 godzinach odświeżamy go w tle
+static const qint64 DefaultCatalogTtlMs = 6 * 60 * 60 * 1000;
+
+StationCatalog::StationCatalog()
+    : m_ttlMs(DefaultCatalogTtlMs) {
+}
+
+bool StationCatalog::loadSnapshot() {
+    return !m_snapshotPath.isEmpty() && m_snapshot.map(m_snapshotPath);
+}
+
+void StationCatalog::setStations(const QList<StationRecord> &stations) {
+    setSnapshot(CatalogSnapshot::build(stations, QDateTime::currentMSecsSinceEpoch()));
+}
+
+void StationCatalog::setSnapshot(const QByteArray &bytes) {
+    // Nowa migawka trafia do pliku tymczasowego i zastępuje starą przez zmianę nazwy.
+    // Starą mapę zwalniamy tuż przed podmianą (Windows nie podmienia zmapowanego pliku).
+    if (!m_snapshotPath.isEmpty()) {
+        QDir().mkpath(QFileInfo(m_snapshotPath).absolutePath());
+
+        QSaveFile file(m_snapshotPath);
+        if (file.open(QIODevice::WriteOnly) && file.write(bytes) == bytes.size()) {
+            m_snapshot.close();
+            if (file.commit() && m_snapshot.map(m_snapshotPath)) {
+                return;
+            }
+        }
+        qDebug() << "Nie udało się zapisać migawki katalogu stacji:" << file.errorString();
+    }
+
+    // Bez pliku katalog działa na tej samej migawce trzymanej w pamięci
+    m_snapshot.setData(bytes);
+}
+
+bool StationCatalog::isFresh() const {
+    return !isEmpty() && QDateTime::currentMSecsSinceEpoch() - m_snapshot.createdAt() < m_ttlMs;
+}
+
+QList<StationRecord> StationCatalog::stationsInCity(const QString &cityName) const {
+    return m_snapshot.stationsInCity(normalizeCity(cityName));
+}
+
+QList<StationRecord> StationCatalog::stations() const {
+    QList<StationRecord> result;
+    result.reserve(m_snapshot.stationCount());
+    for (int i = 0; i < m_snapshot.stationCount(); ++i) {
+        result.append(m_snapshot.stationAt(i));
+    }
+    return result;
+}
+
+QString StationCatalog::normalizeCity(const QString &cityName) {
+    QString key = cityName.trimmed().toLower();
+
+    // Zamieniamy polskie znaki na ich odpowiedniki bez ogonków,
+    // żeby "Krakow" i "Kraków" trafiały w ten sam klucz
+    for (QChar &ch : key) {
+        switch (ch.unicode()) {
+        case u'ą': ch = u'a'; break;
+        case u'ć': ch = u'c'; break;
+        case u'ę': ch = u'e'; break;
+        case u'ł': ch = u'l'; break;
+        case u'ń': ch = u'n'; break;
+        case u'ó': ch = u'o'; break;
+        case u'ś': ch = u's'; break;
+        case u'ź': ch = u'z'; break;
+        case u'ż': ch = u'z'; break;
+        default: break;
+        }
+    }
+    return key;
+}
@@ -0,0 +1,57 @@
+#ifndef STATIONCATALOG_H
+#define STATIONCATALOG_H
+
+#include <QString>
+#include <QList>
+
+#include "catalogsnapshot.h"
+
+// Podstawowe dane stacji pomiarowej z katalogu station/findAll
+struct StationRecord {
+    int id = 0;
+    QString name;
+    QString city;
+    QString lat;
+    QString lon;
+    QString address;
+};
+
+// Katalog wszystkich stacji pobierany raz i indeksowany po nazwie miasta.
+// Dane leżą w binarnej migawce (CatalogSnapshot), która jest zapisywana na dysk
+// i przy starcie mapowana do pamięci - katalog jest dostępny od razu, bez sieci
+// i bez parsowania. Wyszukiwanie stacji w mieście nie wymaga zapytania do API.
+class StationCatalog {
+public:
+    StationCatalog();
+
+    // Plik migawki katalogu
+    void setSnapshotPath(const QString &path) { m_snapshotPath = path; }
+    // Mapuje zapisaną migawkę; false, jeśli jej nie ma lub jest uszkodzona
+    bool loadSnapshot();
+
+    // Zastępuje zawartość katalogu: zapisuje nową migawkę (atomowo) i ją mapuje
+    void setStations(const QList<StationRecord> &stations);
+    // To samo dla migawki zbudowanej wcześniej (CatalogSnapshot::build, np. w innym wątku)
+    void setSnapshot(const QByteArray &bytes);
+
+    bool isEmpty() const { return m_snapshot.stationCount() == 0; }
+    // Czy katalog jest młodszy niż TTL (liczone od pobrania, także między uruchomieniami)
+    bool isFresh() const;
+    qint64 ttlMs() const { return m_ttlMs; }
+    void setTtlMs(qint64 ttlMs) { m_ttlMs = ttlMs; }
+
+    // Stacje w podanym mieście - wyszukiwanie binarne w migawce
+    QList<StationRecord> stationsInCity(const QString &cityName) const;
+    QList<StationRecord> stations() const;
+
+    // Klucz indeksu: nazwa miasta małymi literami, bez polskich znaków
+    // i białych znaków na końcach
+    static QString normalizeCity(const QString &cityName);
+
+private:
+    CatalogSnapshot m_snapshot;
+    QString m_snapshotPath;
+    qint64 m_ttlMs;
+};
+
+#endif // STATIONCATALOG_H
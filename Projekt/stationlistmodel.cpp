@@ -0,0 +1,136 @@
+#include "stationlistmodel.h"
+#include <QSet>
+
+StationListModel::StationListModel(QObject *parent)
+    : QAbstractListModel(parent) {
+}
+
+int StationListModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_stations.size();
+}
+
+QVariant StationListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_stations.size()) {
+        return QVariant();
+    }
+
+    const StationRecord &station = m_stations[index.row()];
+    switch (role) {
+    case StationIdRole:
+        return station.id;
+    case Qt::DisplayRole:
+    case StationNameRole:
+        return station.name;
+    case LatRole:
+        return station.lat;
+    case LonRole:
+        return station.lon;
+    case AddressRole:
+        return station.address;
+    case CityRole:
+        return station.city;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StationListModel::roleNames() const {
+    return {
+        {StationIdRole, "stationId"},
+        {StationNameRole, "stationName"},
+        {LatRole, "lat"},
+        {LonRole, "lon"},
+        {AddressRole, "address"},
+        {CityRole, "city"}
+    };
+}
+
+static bool sameStation(const StationRecord &a, const StationRecord &b) {
+    return a.id == b.id && a.name == b.name && a.city == b.city
+           && a.lat == b.lat && a.lon == b.lon && a.address == b.address;
+}
+
+void StationListModel::setStations(const QList<StationRecord> &stations) {
+    const int oldCount = m_stations.size();
+
+    QSet<int> newIds;
+    newIds.reserve(stations.size());
+    for (const StationRecord &station : stations) {
+        newIds.insert(station.id);
+    }
+
+    // Usuwamy stacje, których nie ma na nowej liście - ciągłymi blokami od końca
+    for (int last = m_stations.size() - 1; last >= 0;) {
+        if (newIds.contains(m_stations[last].id)) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !newIds.contains(m_stations[first - 1].id)) {
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        m_stations.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // Aktualizujemy istniejące wiersze i zbieramy nowe stacje
+    QHash<int, int> rowById;
+    for (int row = 0; row < m_stations.size(); ++row) {
+        rowById.insert(m_stations[row].id, row);
+    }
+
+    QList<StationRecord> added;
+    for (const StationRecord &station : stations) {
+        const auto it = rowById.constFind(station.id);
+        if (it == rowById.constEnd()) {
+            added.append(station);
+        } else if (!sameStation(m_stations[it.value()], station)) {
+            m_stations[it.value()] = station;
+            const QModelIndex changed = index(it.value());
+            emit dataChanged(changed, changed);
+        }
+    }
+
+    if (!added.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_stations.size(), m_stations.size() + added.size() - 1);
+        m_stations.append(added);
+        endInsertRows();
+    }
+
+    if (m_stations.size() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void StationListModel::clear() {
+    if (m_stations.isEmpty()) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), 0, m_stations.size() - 1);
+    m_stations.clear();
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+QVariantMap StationListModel::get(int row) const {
+    QVariantMap result;
+    if (row < 0 || row >= m_stations.size()) {
+        return result;
+    }
+
+    const StationRecord &station = m_stations[row];
+    result["stationId"] = station.id;
+    result["stationName"] = station.name;
+    result["lat"] = station.lat;
+    result["lon"] = station.lon;
+    result["address"] = station.address;
+    result["city"] = station.city;
+    return result;
+}
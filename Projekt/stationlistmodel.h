@@ -0,0 +1,47 @@
+#ifndef STATIONLISTMODEL_H
+#define STATIONLISTMODEL_H
+
+#include <QAbstractListModel>
+
+#include "stationcatalog.h"
+
+// Lista stacji w wybranym mieście udostępniana w QML.
+// Zmiany są nanoszone wiersz po wierszu, więc ListView nie odtwarza
+// wszystkich delegatów przy każdym wyszukiwaniu.
+class StationListModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        StationIdRole = Qt::UserRole + 1,
+        StationNameRole,
+        LatRole,
+        LonRole,
+        AddressRole,
+        CityRole
+    };
+
+    explicit StationListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Ustawia nową listę: usuwa brakujące stacje, aktualizuje zmienione
+    // i dopisuje nowe
+    void setStations(const QList<StationRecord> &stations);
+    void clear();
+
+    const QList<StationRecord> &stations() const { return m_stations; }
+    // Dane stacji z danego wiersza (dla QML)
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+signals:
+    void countChanged();
+
+private:
+    QList<StationRecord> m_stations;
+};
+
+#endif // STATIONLISTMODEL_H
@@ -0,0 +1,116 @@
+#include "stationlistreader.h"
+
+// Układ odpowiedzi: tablica obiektów stacji (głębokość 2), a w nich obiekt
+// "city" (głębokość 3) z polem "name"
+static const int StationDepth = 2;
+static const int CityDepth = 3;
+
+StationListReader::StationListReader()
+    : m_field(OtherField),
+    m_cityName(false),
+    m_failed(false) {
+}
+
+bool StationListReader::feed(QByteArrayView data) {
+    if (m_failed) {
+        return false;
+    }
+    m_tokenizer.feed(data);
+    return readTokens();
+}
+
+bool StationListReader::finish() {
+    if (m_failed) {
+        return false;
+    }
+    m_tokenizer.finish();
+    return readTokens() && m_tokenizer.next() == JsonTokenizer::EndOfData;
+}
+
+StationListReader::Field StationListReader::fieldFor(QByteArrayView key) {
+    if (key == "id") {
+        return IdField;
+    }
+    if (key == "stationName") {
+        return NameField;
+    }
+    if (key == "gegrLat") {
+        return LatField;
+    }
+    if (key == "gegrLon") {
+        return LonField;
+    }
+    if (key == "addressStreet") {
+        return AddressField;
+    }
+    if (key == "city") {
+        return CityField;
+    }
+    return OtherField;
+}
+
+bool StationListReader::readTokens() {
+    for (;;) {
+        const JsonTokenizer::Token token = m_tokenizer.next();
+        const int depth = m_tokenizer.depth();
+
+        switch (token) {
+        case JsonTokenizer::NeedMoreData:
+        case JsonTokenizer::EndOfData:
+            return true;
+        case JsonTokenizer::Error:
+            m_failed = true;
+            return false;
+        case JsonTokenizer::BeginObject:
+            if (depth == StationDepth) {
+                m_current = StationRecord();
+                m_field = OtherField;
+            }
+            break;
+        case JsonTokenizer::EndObject:
+            // Zamknięty obiekt stacji - wracamy do tablicy
+            if (depth == StationDepth - 1) {
+                m_stations.append(m_current);
+            }
+            break;
+        case JsonTokenizer::Key:
+            if (depth == StationDepth) {
+                m_field = fieldFor(m_tokenizer.text());
+                m_cityName = false;
+            } else if (depth == CityDepth) {
+                m_cityName = m_field == CityField && m_tokenizer.text() == "name";
+            }
+            break;
+        case JsonTokenizer::String:
+        case JsonTokenizer::Number:
+            if (depth == StationDepth) {
+                // Współrzędne są w API tekstem; liczbę przepisujemy bez zmian
+                switch (m_field) {
+                case IdField:
+                    m_current.id = int(m_tokenizer.number());
+                    break;
+                case NameField:
+                    m_current.name = m_tokenizer.string();
+                    break;
+                case LatField:
+                    m_current.lat = m_tokenizer.string();
+                    break;
+                case LonField:
+                    m_current.lon = m_tokenizer.string();
+                    break;
+                case AddressField:
+                    m_current.address = m_tokenizer.string();
+                    break;
+                case CityField:
+                case OtherField:
+                    break;
+                }
+            } else if (depth == CityDepth && m_cityName) {
+                m_current.city = m_tokenizer.string();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef STATIONLISTREADER_H
+#define STATIONLISTREADER_H
+
+#include <QByteArrayView>
+#include <QList>
+
+#include "jsontokenizer.h"
+#include "stationcatalog.h"
+
+// Odczyt odpowiedzi station/findAll fragment po fragmencie, bez drzewa JSON.
+// Stacja trafia do stations() zaraz po zamknięciu jej obiektu, więc parsowanie
+// postępuje razem z pobieraniem, a w pamięci są tylko gotowe rekordy.
+class StationListReader {
+public:
+    StationListReader();
+
+    // Przetwarza kolejny fragment odpowiedzi; false po błędzie składni
+    bool feed(QByteArrayView data);
+    // Koniec odpowiedzi; false, jeśli dokument był błędny lub niekompletny
+    bool finish();
+
+    const QList<StationRecord> &stations() const { return m_stations; }
+
+private:
+    // Pola obiektu stacji, które zapisujemy w StationRecord
+    enum Field {
+        OtherField,
+        IdField,
+        NameField,
+        LatField,
+        LonField,
+        AddressField,
+        CityField
+    };
+
+    static Field fieldFor(QByteArrayView key);
+    bool readTokens();
+
+    JsonTokenizer m_tokenizer;
+    QList<StationRecord> m_stations;
+    StationRecord m_current;  // Stacja, której obiekt jest właśnie czytany
+    Field m_field;            // Pole stacji, do którego należy bieżąca wartość
+    bool m_cityName;          // Czy bieżąca wartość to city.name
+    bool m_failed;
+};
+
+#endif // STATIONLISTREADER_H
@@ -0,0 +1,339 @@
+#include <QtTest>
+#include <QDateTime>
+#include <QHash>
+#include <QLocale>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+
+#include "requestscheduler.h"
+#include "responsecache.h"
+
+// Lokalny serwer HTTP w roli API GIOŚ. Każdy zasób ma treść i ETag;
+// zapytanie warunkowe z aktualnym ETagiem dostaje 304 bez treści.
+// Nagłówki Cache-Control serwera zabraniają przechowywania odpowiedzi
+// dłużej niż chwilę - ResponseCache ma je zastąpić własnym czasem ważności.
+class MockServer {
+public:
+    struct Resource {
+        QByteArray body;
+        QByteArray etag;
+    };
+
+    bool listen() {
+        QObject::connect(&m_server, &QTcpServer::newConnection, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() {
+                    handle(socket);
+                });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+        return m_server.listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url(const QString &path) const {
+        return QUrl(QString("http://127.0.0.1:%1%2").arg(m_server.serverPort()).arg(path));
+    }
+
+    void setResource(const QByteArray &path, const QByteArray &body, const QByteArray &etag) {
+        m_resources.insert(path, {body, etag});
+    }
+
+    int requests = 0;             // Wszystkie zapytania, które dotarły do serwera
+    int conditionalRequests = 0;  // Zapytania z If-None-Match
+    int notModified = 0;          // Odpowiedzi 304
+
+private:
+    void handle(QTcpSocket *socket) {
+        QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+
+        // Połączenie może nieść kolejne zapytania (keep-alive); GET nie ma treści
+        qsizetype headerEnd;
+        while ((headerEnd = buffer.indexOf("\r\n\r\n")) >= 0) {
+            const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+            buffer.remove(0, headerEnd + 4);
+
+            const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+            const QByteArray path = requestLine.value(1);
+            QByteArray ifNoneMatch;
+            for (const QByteArray &line : lines.mid(1)) {
+                const qsizetype colon = line.indexOf(':');
+                if (line.left(colon).trimmed().compare("If-None-Match", Qt::CaseInsensitive) == 0) {
+                    ifNoneMatch = line.mid(colon + 1).trimmed();
+                }
+            }
+
+            requests++;
+            if (!ifNoneMatch.isEmpty()) {
+                conditionalRequests++;
+            }
+            socket->write(respond(path, ifNoneMatch));
+        }
+
+        socket->setProperty("buffer", buffer);
+    }
+
+    QByteArray respond(const QByteArray &path, const QByteArray &ifNoneMatch) {
+        const auto it = m_resources.constFind(path);
+        if (it == m_resources.constEnd()) {
+            return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+        }
+
+        const QByteArray date = QLocale::c().toString(QDateTime::currentDateTimeUtc(),
+                                                      "ddd, dd MMM yyyy hh:mm:ss 'GMT'").toLatin1();
+        QByteArray headers = "Date: " + date + "\r\n"
+                             "ETag: " + it->etag + "\r\n"
+                             "Cache-Control: max-age=0\r\n";
+
+        if (ifNoneMatch == it->etag) {
+            notModified++;
+            return "HTTP/1.1 304 Not Modified\r\n" + headers + "\r\n";
+        }
+        return "HTTP/1.1 200 OK\r\n" + headers
+               + "Content-Type: application/octet-stream\r\n"
+               + "Content-Length: " + QByteArray::number(it->body.size()) + "\r\n\r\n"
+               + it->body;
+    }
+
+    QTcpServer m_server;
+    QHash<QByteArray, Resource> m_resources;
+};
+
+class ResponseCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void ttlForEndpoints();
+    void missThenHit();
+    void expiryFollowsTtl();
+    void staleEntryIsRevalidated();
+    void changedResourceAfterExpiry();
+    void zeroTtlAlwaysRevalidated();
+    void diskSizeIsCapped();
+
+private:
+    // Pobiera adres przez kolejkę i zwraca treść odpowiedzi
+    bool fetch(const QByteArray &path, QByteArray *body = nullptr);
+    // Przesuwa czas ważności wpisu w przeszłość, z pominięciem ResponseCache::updateMetaData()
+    void expire(const QByteArray &path);
+
+    MockServer m_server;
+    QTemporaryDir *m_cacheDir = nullptr;
+    QNetworkAccessManager *m_manager = nullptr;
+    ResponseCache *m_cache = nullptr;
+    RequestScheduler *m_scheduler = nullptr;
+};
+
+static const QByteArray SensorDataPath = "/pjp-api/rest/data/getData/92";
+static const QByteArray StationListPath = "/pjp-api/rest/station/findAll";
+static const QByteArray UnlistedPath = "/pjp-api/rest/other/1";
+
+void ResponseCacheTest::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_server.listen());
+
+    m_server.setResource(SensorDataPath, R"({"key":"PM10","values":[]})", "\"v1\"");
+    m_server.setResource(StationListPath, "[]", "\"catalog\"");
+    m_server.setResource(UnlistedPath, "{}", "\"other\"");
+}
+
+void ResponseCacheTest::init() {
+    m_cacheDir = new QTemporaryDir;
+    QVERIFY(m_cacheDir->isValid());
+
+    m_manager = new QNetworkAccessManager;
+    m_manager->setProxy(QNetworkProxy::NoProxy);
+    m_cache = new ResponseCache(m_manager);
+    m_cache->setCacheDirectory(m_cacheDir->path());
+    m_manager->setCache(m_cache);
+    m_scheduler = new RequestScheduler(m_manager);
+
+    m_server.requests = 0;
+    m_server.conditionalRequests = 0;
+    m_server.notModified = 0;
+}
+
+void ResponseCacheTest::cleanup() {
+    delete m_scheduler;
+    delete m_manager;
+    delete m_cacheDir;
+}
+
+bool ResponseCacheTest::fetch(const QByteArray &path, QByteArray *body) {
+    bool finished = false;
+    bool ok = false;
+    const QMetaObject::Connection connection = connect(
+        m_scheduler, &RequestScheduler::replyFinished, this,
+        [&](QNetworkReply *reply, const QList<QNetworkRequest> &) {
+            ok = reply->error() == QNetworkReply::NoError;
+            if (body) {
+                *body = reply->readAll();
+            }
+            reply->deleteLater();
+            finished = true;
+        });
+
+    m_scheduler->enqueue(QNetworkRequest(m_server.url(QString::fromLatin1(path))));
+    const bool answered = QTest::qWaitFor([&finished]() { return finished; }, 5000);
+    disconnect(connection);
+    return answered && ok;
+}
+
+void ResponseCacheTest::expire(const QByteArray &path) {
+    QNetworkCacheMetaData metaData = m_cache->metaData(m_server.url(QString::fromLatin1(path)));
+    QVERIFY(metaData.isValid());
+    metaData.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(-60));
+    m_cache->QNetworkDiskCache::updateMetaData(metaData);
+    QVERIFY(!ResponseCache::isFresh(m_cache->metaData(metaData.url())));
+}
+
+void ResponseCacheTest::ttlForEndpoints() {
+    const qint64 minute = 60 * 1000;
+    QCOMPARE(ResponseCache::ttlFor(QUrl("https://api.gios.gov.pl/pjp-api/rest/station/findAll")), 360 * minute);
+    QCOMPARE(ResponseCache::ttlFor(QUrl("https://api.gios.gov.pl/pjp-api/rest/station/sensors/14")), 360 * minute);
+    QCOMPARE(ResponseCache::ttlFor(QUrl("https://api.gios.gov.pl/pjp-api/rest/data/getData/92")), 15 * minute);
+    QCOMPARE(ResponseCache::ttlFor(QUrl("https://api.gios.gov.pl/pjp-api/rest/aqindex/getIndex/14")), 15 * minute);
+    // Host nie ma znaczenia, liczy się ścieżka
+    QCOMPARE(ResponseCache::ttlFor(m_server.url(QString::fromLatin1(SensorDataPath))), 15 * minute);
+    QCOMPARE(ResponseCache::ttlFor(QUrl("https://api.gios.gov.pl/pjp-api/rest/other/1")), qint64(0));
+}
+
+void ResponseCacheTest::missThenHit() {
+    QByteArray first;
+    QByteArray second;
+    QVERIFY(fetch(SensorDataPath, &first));
+    QVERIFY(fetch(SensorDataPath, &second));
+
+    // Drugie pobranie nie dotarło do serwera
+    QCOMPARE(m_server.requests, 1);
+    QCOMPARE(second, first);
+    QCOMPARE(m_scheduler->cacheMisses(), 1);
+    QCOMPARE(m_scheduler->cacheHits(), 1);
+    QCOMPARE(m_scheduler->cacheRevalidations(), 0);
+}
+
+void ResponseCacheTest::expiryFollowsTtl() {
+    const QDateTime before = QDateTime::currentDateTimeUtc();
+    QVERIFY(fetch(StationListPath));
+    const QDateTime after = QDateTime::currentDateTimeUtc();
+
+    // Serwer podał max-age=0, a wpis żyje tyle, ile przewiduje ttlFor()
+    const QNetworkCacheMetaData metaData = m_cache->metaData(m_server.url(QString::fromLatin1(StationListPath)));
+    QVERIFY(metaData.isValid());
+    const qint64 ttl = ResponseCache::ttlFor(metaData.url());
+    QVERIFY(metaData.expirationDate() >= before.addMSecs(ttl).addSecs(-1));
+    QVERIFY(metaData.expirationDate() <= after.addMSecs(ttl).addSecs(1));
+    QVERIFY(ResponseCache::isFresh(metaData));
+
+    // Cache-Control nie zostaje we wpisie, ETag - tak (do zapytań warunkowych)
+    bool hasCacheControl = false;
+    bool hasETag = false;
+    for (const QNetworkCacheMetaData::RawHeader &header : metaData.rawHeaders()) {
+        hasCacheControl |= header.first.compare("Cache-Control", Qt::CaseInsensitive) == 0;
+        hasETag |= header.first.compare("ETag", Qt::CaseInsensitive) == 0;
+    }
+    QVERIFY(!hasCacheControl);
+    QVERIFY(hasETag);
+}
+
+void ResponseCacheTest::staleEntryIsRevalidated() {
+    QByteArray first;
+    QVERIFY(fetch(SensorDataPath, &first));
+    expire(SensorDataPath);
+
+    QByteArray second;
+    QVERIFY(fetch(SensorDataPath, &second));
+
+    // Zapytanie warunkowe, 304 i treść z dysku
+    QCOMPARE(m_server.requests, 2);
+    QCOMPARE(m_server.conditionalRequests, 1);
+    QCOMPARE(m_server.notModified, 1);
+    QCOMPARE(second, first);
+    QCOMPARE(m_scheduler->cacheMisses(), 1);
+    QCOMPARE(m_scheduler->cacheRevalidations(), 1);
+    QCOMPARE(m_scheduler->cacheHits(), 0);
+
+    // Odpowiedź 304 odnawia czas ważności - kolejne pobranie to trafienie
+    QVERIFY(ResponseCache::isFresh(m_cache->metaData(m_server.url(QString::fromLatin1(SensorDataPath)))));
+    QVERIFY(fetch(SensorDataPath));
+    QCOMPARE(m_server.requests, 2);
+    QCOMPARE(m_scheduler->cacheHits(), 1);
+}
+
+void ResponseCacheTest::changedResourceAfterExpiry() {
+    const QByteArray path = "/pjp-api/rest/aqindex/getIndex/14";
+    m_server.setResource(path, R"({"stIndexLevel":{"indexLevelName":"Dobry"}})", "\"a\"");
+    QVERIFY(fetch(path));
+    expire(path);
+
+    // Nowa treść pod tym samym adresem - serwer odpowiada 200 zamiast 304
+    const QByteArray changed = R"({"stIndexLevel":{"indexLevelName":"Umiarkowany"}})";
+    m_server.setResource(path, changed, "\"b\"");
+    QByteArray body;
+    QVERIFY(fetch(path, &body));
+
+    QCOMPARE(body, changed);
+    QCOMPARE(m_server.conditionalRequests, 1);
+    QCOMPARE(m_server.notModified, 0);
+    QCOMPARE(m_scheduler->cacheMisses(), 2);
+    QCOMPARE(m_scheduler->cacheRevalidations(), 0);
+
+    // Wpis ma nową treść
+    QVERIFY(fetch(path, &body));
+    QCOMPARE(body, changed);
+    QCOMPARE(m_scheduler->cacheHits(), 1);
+}
+
+void ResponseCacheTest::zeroTtlAlwaysRevalidated() {
+    QVERIFY(fetch(UnlistedPath));
+    QVERIFY(fetch(UnlistedPath));
+    QVERIFY(fetch(UnlistedPath));
+
+    // Adres spoza tabeli czasów ważności jest zawsze sprawdzany na serwerze
+    QCOMPARE(m_server.requests, 3);
+    QCOMPARE(m_server.conditionalRequests, 2);
+    QCOMPARE(m_scheduler->cacheMisses(), 1);
+    QCOMPARE(m_scheduler->cacheRevalidations(), 2);
+    QCOMPARE(m_scheduler->cacheHits(), 0);
+}
+
+void ResponseCacheTest::diskSizeIsCapped() {
+    QCOMPARE(ResponseCache().maximumCacheSize(), qint64(20 * 1024 * 1024));
+
+    // Losowe bajty - wpisy nie skurczą się przy kompresji
+    const qint64 maximumSize = 64 * 1024;
+    const int resourceCount = 16;
+    m_cache->setMaximumCacheSize(maximumSize);
+    for (int i = 0; i < resourceCount; ++i) {
+        QByteArray body(16 * 1024, Qt::Uninitialized);
+        QRandomGenerator::global()->fillRange(reinterpret_cast<quint32 *>(body.data()), body.size() / 4);
+        m_server.setResource("/pjp-api/rest/data/getData/" + QByteArray::number(1000 + i), body,
+                             "\"" + QByteArray::number(i) + "\"");
+    }
+
+    int cached = 0;
+    for (int i = 0; i < resourceCount; ++i) {
+        QVERIFY(fetch("/pjp-api/rest/data/getData/" + QByteArray::number(1000 + i)));
+    }
+    for (int i = 0; i < resourceCount; ++i) {
+        const QString path = "/pjp-api/rest/data/getData/" + QString::number(1000 + i);
+        cached += m_cache->metaData(m_server.url(path)).isValid() ? 1 : 0;
+    }
+
+    // Najstarsze wpisy zostały usunięte, a pamięć nie przekracza limitu
+    QVERIFY(m_cache->cacheSize() <= maximumSize);
+    QVERIFY(cached > 0);
+    QVERIFY(cached < resourceCount);
+    QCOMPARE(m_scheduler->cacheMisses(), resourceCount);
+}
+
+QTEST_GUILESS_MAIN(ResponseCacheTest)
+#include "tst_responsecache.moc"
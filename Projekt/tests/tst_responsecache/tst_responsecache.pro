@@ -0,0 +1,21 @@
+# Testy pamięci podręcznej odpowiedzi (ResponseCache + RequestScheduler)
+# z lokalnym serwerem HTTP zamiast API GIOŚ. Uruchomienie: qmake && make check
+
+QT += testlib network
+QT -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_responsecache
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_responsecache.cpp \
+    ../../responsecache.cpp \
+    ../../requestscheduler.cpp
+
+HEADERS += \
+    ../../responsecache.h \
+    ../../requestscheduler.h
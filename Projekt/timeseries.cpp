@@ -0,0 +1,152 @@
+#include "timeseries.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+void TimeSeries::clear() {
+    m_timestamps.clear();
+    m_values.clear();
+}
+
+void TimeSeries::reserve(int size) {
+    m_timestamps.reserve(size);
+    m_values.reserve(size);
+}
+
+void TimeSeries::append(qint64 timestamp, float value) {
+    m_timestamps.append(timestamp);
+    m_values.append(value);
+}
+
+void TimeSeries::sortByTime() {
+    const int count = m_timestamps.size();
+    if (count < 2) {
+        return;
+    }
+
+    // API zwraca pomiary od najnowszych - wtedy wystarczy odwrócić kolejność
+    const bool ascending = std::is_sorted(m_timestamps.cbegin(), m_timestamps.cend());
+    if (!ascending) {
+        const bool descending = std::is_sorted(m_timestamps.crbegin(), m_timestamps.crend());
+        if (descending) {
+            std::reverse(m_timestamps.begin(), m_timestamps.end());
+            std::reverse(m_values.begin(), m_values.end());
+        } else {
+            // Dowolna kolejność - sortujemy indeksy i przepisujemy obie kolumny
+            QList<int> order(count);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+                return m_timestamps[a] < m_timestamps[b];
+            });
+
+            QList<qint64> timestamps;
+            QList<float> values;
+            timestamps.reserve(count);
+            values.reserve(count);
+            for (int index : order) {
+                timestamps.append(m_timestamps[index]);
+                values.append(m_values[index]);
+            }
+            m_timestamps = timestamps;
+            m_values = values;
+        }
+    }
+
+    // Usuwamy powtórzone znaczniki czasu (zostaje ostatnia wartość)
+    int write = 0;
+    for (int read = 1; read < count; ++read) {
+        if (m_timestamps[read] == m_timestamps[write]) {
+            m_values[write] = m_values[read];
+        } else {
+            ++write;
+            m_timestamps[write] = m_timestamps[read];
+            m_values[write] = m_values[read];
+        }
+    }
+    m_timestamps.resize(write + 1);
+    m_values.resize(write + 1);
+}
+
+void TimeSeries::removeFirst(int count) {
+    count = qMin(count, size());
+    if (count <= 0) {
+        return;
+    }
+    m_timestamps.remove(0, count);
+    m_values.remove(0, count);
+}
+
+int TimeSeries::lowerBound(qint64 timestamp) const {
+    return int(std::lower_bound(m_timestamps.cbegin(), m_timestamps.cend(), timestamp) - m_timestamps.cbegin());
+}
+
+int TimeSeries::upperBound(qint64 timestamp) const {
+    return int(std::upper_bound(m_timestamps.cbegin(), m_timestamps.cend(), timestamp) - m_timestamps.cbegin());
+}
+
+RangeStats TimeSeries::stats(int first, int last) const {
+    RangeStats result;
+    first = qMax(0, first);
+    last = qMin(last, size());
+    if (first >= last) {
+        return result;
+    }
+
+    const float *values = m_values.constData();
+    float minValue = values[first];
+    float maxValue = minValue;
+    int argMin = first;
+    int argMax = first;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+
+    for (int i = first; i < last; ++i) {
+        const float value = values[i];
+        if (value < minValue) {
+            minValue = value;
+            argMin = i;
+        }
+        if (value > maxValue) {
+            maxValue = value;
+            argMax = i;
+        }
+        sum += value;
+        sumSquares += double(value) * value;
+    }
+
+    const int count = last - first;
+    result.count = count;
+    result.min = minValue;
+    result.max = maxValue;
+    result.argMin = argMin;
+    result.argMax = argMax;
+    result.mean = sum / count;
+    // Wariancja jako E[x^2] - E[x]^2; błędy zaokrągleń mogą dać minimalnie ujemny wynik
+    result.stdDev = std::sqrt(qMax(0.0, sumSquares / count - result.mean * result.mean));
+    return result;
+}
+
+float TimeSeries::percentile(int first, int last, double p, QList<float> &scratch) const {
+    first = qMax(0, first);
+    last = qMin(last, size());
+    if (first >= last) {
+        return 0.0f;
+    }
+
+    // nth_element przestawia elementy, więc pracujemy na kopii wartości
+    const int count = last - first;
+    scratch.resize(count);
+    std::copy(m_values.cbegin() + first, m_values.cbegin() + last, scratch.begin());
+
+    const double position = qBound(0.0, p, 100.0) / 100.0 * (count - 1);
+    const int lower = int(position);
+    std::nth_element(scratch.begin(), scratch.begin() + lower, scratch.end());
+    const float lowerValue = scratch[lower];
+    if (lower + 1 >= count) {
+        return lowerValue;
+    }
+
+    // Następna pozycja to najmniejszy element za lower
+    const float upperValue = *std::min_element(scratch.cbegin() + lower + 1, scratch.cend());
+    return float(lowerValue + (upperValue - lowerValue) * (position - lower));
+}
@@ -0,0 +1,72 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <QString>
+#include <QList>
+
+// Opis serii pomiarowej (wspólny dla wszystkich punktów)
+struct SeriesInfo {
+    int sensorId = 0;
+    QString param;
+    QString paramFormula;
+    QString unit;
+};
+
+// Statystyki punktów z przedziału indeksów serii
+struct RangeStats {
+    int count = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+    int argMin = -1;    // Indeks punktu z wartością minimalną
+    int argMax = -1;    // Indeks punktu z wartością maksymalną
+    double mean = 0.0;
+    double stdDev = 0.0;  // Odchylenie standardowe populacji
+};
+
+// Seria pomiarów w układzie kolumnowym: posortowane rosnąco znaczniki czasu
+// (ms od epoki) i wartości w osobnych tablicach - 12 bajtów na punkt.
+class TimeSeries {
+public:
+    SeriesInfo &info() { return m_info; }
+    const SeriesInfo &info() const { return m_info; }
+
+    int size() const { return m_timestamps.size(); }
+    bool isEmpty() const { return m_timestamps.isEmpty(); }
+    void clear();
+    void reserve(int size);
+
+    // Dodaje punkt na końcu; po dodaniu punktów w dowolnej kolejności
+    // należy wywołać sortByTime()
+    void append(qint64 timestamp, float value);
+    // Sortuje punkty rosnąco po czasie i usuwa duplikaty znaczników
+    void sortByTime();
+    // Usuwa count najstarszych punktów
+    void removeFirst(int count);
+    void setValueAt(int index, float value) { m_values[index] = value; }
+
+    qint64 timestampAt(int index) const { return m_timestamps[index]; }
+    float valueAt(int index) const { return m_values[index]; }
+    qint64 firstTimestamp() const { return m_timestamps.isEmpty() ? 0 : m_timestamps.first(); }
+    qint64 lastTimestamp() const { return m_timestamps.isEmpty() ? 0 : m_timestamps.last(); }
+
+    const QList<qint64> &timestamps() const { return m_timestamps; }
+    const QList<float> &values() const { return m_values; }
+
+    // Indeks pierwszego punktu z czasem >= timestamp (wyszukiwanie binarne)
+    int lowerBound(qint64 timestamp) const;
+    // Indeks pierwszego punktu z czasem > timestamp
+    int upperBound(qint64 timestamp) const;
+
+    // Minimum, maksimum (z indeksami), średnia i odchylenie dla [first, last) w jednym przebiegu
+    RangeStats stats(int first, int last) const;
+    // Percentyl p (0-100) wartości z [first, last) z interpolacją liniową między
+    // sąsiednimi pozycjami. scratch to bufor roboczy używany ponownie przez wywołującego.
+    float percentile(int first, int last, double p, QList<float> &scratch) const;
+
+private:
+    SeriesInfo m_info;
+    QList<qint64> m_timestamps;
+    QList<float> m_values;
+};
+
+#endif // TIMESERIES_H